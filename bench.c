@@ -0,0 +1,2710 @@
+/*
+ * File         : bench.c
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Micro benchmarks for the movie database. Builds a synthetic
+ *                collection from a fixed seed so every run measures the same
+ *                work. Not part of the NetBeans project as it has its own
+ *                main(); build and run it with "make bench".
+ *
+ * Usage        : bench [section] [films]
+ *
+ * History      : 19/10/2026 v1.00 - sort section
+ *                19/10/2026 v1.10 - groupby section
+ *                19/10/2026 v1.20 - parse section
+ *                19/10/2026 v1.30 - upsert section
+ *                19/10/2026 v1.40 - journal section
+ *                19/10/2026 v1.50 - catalogue section
+ *                19/10/2026 v1.60 - loader section
+ *                19/10/2026 v1.70 - traverse section
+ *                19/10/2026 v1.80 - sketch section
+ *                19/10/2026 v1.90 - search section
+ *                19/10/2026 v2.00 - lazy section
+ *                19/10/2026 v2.10 - memory section
+ *                19/10/2026 v2.20 - match section
+ *                19/10/2026 v2.30 - record and gate modes for make perf
+ *                19/10/2026 v2.40 - pipeline section
+ *                19/10/2026 v2.50 - similar section
+ *                19/10/2026 v2.60 - allocation and timing through mvdb.h
+ *                19/10/2026 v2.70 - make perf gates on instructions per film
+ *                                   where they are counted, else on time
+ *                19/10/2026 v2.80 - parse section reads rows after a stray quote
+ *                19/10/2026 v2.90 - upsert section checks a renamed film
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/resource.h>
+
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "film.h"
+#include "moviedatabase.h"
+#include "groupby.h"
+#include "parser.h"
+#include "view.h"
+#include "catalogue.h"
+#include "loader.h"
+#include "sketch.h"
+#include "search.h"
+#include "match.h"
+#include "pipeline.h"
+#include "similar.h"
+#include "mvdb.h"
+
+#define BENCH_SEED 20161027u
+
+static unsigned int bench_state = BENCH_SEED;
+
+static const char* bench_words[] =
+{
+    "The", "Last", "Crusade", "Great", "Dictator", "Wizard", "Night", "City",
+    "Lights", "Man", "Third", "Falcon", "Touch", "Evil", "Rear", "Window",
+    "Strangers", "Train", "Sunset", "Boulevard", "Modern", "Times", "Star"
+};
+
+static const char* bench_ratings[] =
+{
+    "PG-13", "APPROVED", "PASSED", "PG", "R", "NOT RATED", "G", "TV-14"
+};
+
+static const char* bench_genres[] =
+{
+    "Action", "Adventure", "Fantasy", "Comedy", "Drama", "War", "Family",
+    "Romance", "Western", "Crime", "Film-Noir", "Mystery", "Thriller",
+    "Sci-Fi", "Horror", "Animation"
+};
+
+#define BENCH_COUNT(array) (int)(sizeof(array) / sizeof(array[0]))
+
+static unsigned int bench_random()
+{
+    bench_state = bench_state * 1103515245u + 12345u;
+
+    return bench_state >> 8;
+}
+
+/*
+ * Builds one random film, in the same shape as the entries of films.txt.
+ */
+static Film* bench_film()
+{
+    char title[100] = "";
+    char genre[100] = "";
+    int words = 1 + bench_random() % 4;
+    int genres = 1 + bench_random() % 3;
+
+    for (int w = 0; w < words; w++)
+    {
+        strcat(title, w == 0 ? "" : " ");
+        strcat(title, bench_words[bench_random() % BENCH_COUNT(bench_words)]);
+    }
+
+    for (int g = 0; g < genres; g++)
+    {
+        strcat(genre, g == 0 ? "" : "/");
+        strcat(genre, bench_genres[bench_random() % BENCH_COUNT(bench_genres)]);
+    }
+
+    return film_new(title, 1920 + bench_random() % 97,
+            (char*)bench_ratings[bench_random() % BENCH_COUNT(bench_ratings)],
+            genre, 60 + bench_random() % 180,
+            (10 + bench_random() % 90) / 10.0f);
+}
+
+/*
+ * CPU time of this thread, so time the gate spends descheduled is not
+ * counted against a stage.
+ */
+static double bench_cpu()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/*
+ * Fills films with count random films from the fixed seed.
+ */
+static Film** bench_films(int count)
+{
+    Film** films = (Film**)mvdb_alloc(count * sizeof(Film*));
+
+    bench_state = BENCH_SEED;
+
+    for (int i = 0; i < count; i++)
+    {
+        films[i] = bench_film();
+    }
+
+    return films;
+}
+
+static void bench_fill(List* list, Film** films, int count)
+{
+    list_clear(list);
+
+    for (int i = 0; i < count; i++)
+    {
+        list_add(list, films[i]);
+    }
+}
+
+static void bench_freeFilms(Film** films, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        film_free(films[i]);
+    }
+
+    free(films);
+}
+
+/*
+ * Sort section: every sort key through the function pointer path and through
+ * the specialised path. Both run the same bubble sort over the same input, so
+ * they make the same comparisons and the time per comparison can be compared
+ * directly.
+ */
+static long bench_comparisons;
+static int (*bench_comparator)(Mvdb*);
+
+static int bench_counting(Mvdb* node)
+{
+    bench_comparisons++;
+
+    return bench_comparator(node);
+}
+
+typedef struct _BenchSortKey
+{
+    const char* name;
+    int (*comparator)(Mvdb*);
+    void (*specialised)(List*);
+}BenchSortKey;
+
+static void bench_sort(int count)
+{
+    BenchSortKey keys[] =
+    {
+        { "year",         list_year,         list_sortByYear },
+        { "length",       list_lengthS,      list_sortByLength },
+        { "reviewRating", list_reviewRating, list_sortByReviewRating },
+        { "rating",       list_rating,       list_sortByRating },
+        { "genre",        list_genre,        list_sortByGenre },
+        { "title",        list_title,        list_sortByTitle }
+    };
+
+    Film** films = bench_films(count);
+    List* list = list_new();
+
+    printf("sort: %d films, bubble sort\n", count);
+    printf("  %-13s %12s %14s %14s %8s\n", "key", "comparisons",
+            "pointer ns/cmp", "inline ns/cmp", "speedup");
+
+    for (int k = 0; k < BENCH_COUNT(keys); k++)
+    {
+        bench_fill(list, films, count);
+        bench_comparisons = 0;
+        bench_comparator = keys[k].comparator;
+        list_sortBy(list, bench_counting);
+
+        bench_fill(list, films, count);
+        double start = mvdb_now();
+        list_sortBy(list, keys[k].comparator);
+        double pointer = mvdb_now() - start;
+
+        bench_fill(list, films, count);
+        start = mvdb_now();
+        keys[k].specialised(list);
+        double inlined = mvdb_now() - start;
+
+        double comparisons = bench_comparisons > 0 ? bench_comparisons : 1;
+
+        printf("  %-13s %12ld %14.2f %14.2f %7.2fx\n", keys[k].name,
+                bench_comparisons, pointer * 1e9 / comparisons,
+                inlined * 1e9 / comparisons, pointer / inlined);
+    }
+
+    list_clear(list);
+    free(list);
+    bench_freeFilms(films, count);
+}
+
+/*
+ * Groupby section: genre by decade on one thread and on every core, checking
+ * the merged per-thread partials agree with the single threaded result.
+ */
+static void bench_groupby(int count)
+{
+    Film** films = bench_films(count);
+    List* list = list_new();
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    bench_fill(list, films, count);
+
+    double start = mvdb_now();
+    GroupResult* single = groupby_run(list, GROUP_GENRE, GROUP_DECADE, 1);
+    double serial = mvdb_now() - start;
+
+    start = mvdb_now();
+    GroupResult* parallel = groupby_run(list, GROUP_GENRE, GROUP_DECADE,
+            cores);
+    double threaded = mvdb_now() - start;
+
+    int groups = single->columns[0].distinct * single->columns[1].distinct;
+    int agree = 1;
+
+    for (int g = 0; g < groups; g++)
+    {
+        agree &= single->groups[g].count == parallel->groups[g].count
+                && single->groups[g].lengthSum == parallel->groups[g].lengthSum
+                && single->groups[g].reviewMax == parallel->groups[g].reviewMax;
+    }
+
+    printf("groupby: %d films, genre x decade, %d groups\n", count, groups);
+    printf("  1 thread   %8.1f ms  %8.1f Mfilms/s\n", serial * 1e3,
+            count / serial / 1e6);
+    printf("  %d threads %8.1f ms  %8.1f Mfilms/s  %s\n", parallel->threads,
+            threaded * 1e3, count / threaded / 1e6,
+            agree ? "results agree" : "RESULTS DIFFER");
+
+    groupby_free(single);
+    groupby_free(parallel);
+    list_clear(list);
+    free(list);
+    bench_freeFilms(films, count);
+}
+
+/*
+ * Parse section: a dirty films.txt with embedded commas, doubled quotes, long
+ * titles and broken rows, read by the old fgets/sscanf loop and by parser.h.
+ * The old loop is given field widths here so long titles cannot overflow it.
+ * parser.h then reads the same rows after a row with a stray quote, which
+ * makes it read ahead as far as PARSER_MAX_RECORD before rejecting that row;
+ * this should cost no more than reading the rows once more.
+ */
+static void bench_dirtyRow(FILE* output, int row)
+{
+    char title[400];
+    int kind = bench_random() % 20;
+
+    snprintf(title, sizeof(title), "%s %s %d",
+            bench_words[bench_random() % BENCH_COUNT(bench_words)],
+            bench_words[bench_random() % BENCH_COUNT(bench_words)], row);
+
+    switch (kind)
+    {
+        case 0:
+        case 1:
+            fprintf(output, "\"%s, the Sequel\",1966,\"APPROVED\",\"Western\","
+                    "161,8.9\n", title);
+            break;
+        case 2:
+            fprintf(output, "\"The \"\"%s\"\" Affair\",1950,\"PG\","
+                    "\"Comedy/Drama\",99,7.5\n", title);
+            break;
+        case 3:
+            fprintf(output, "\"%s%0300d\",2001,\"G\",\"Animation\",92,8.0\n",
+                    title, 0);
+            break;
+        case 4:
+            fprintf(output, "\"%s\",19x4,\"R\",\"Crime\",101,8.1\n", title);
+            break;
+        case 5:
+            fprintf(output, "\"%s\",1984,\"R\",\"Crime\"\n", title);
+            break;
+        default:
+            fprintf(output, "\"%s\",%d,\"%s\",\"%s\",%d,%.1f\n", title,
+                    1920 + bench_random() % 97,
+                    bench_ratings[bench_random() % BENCH_COUNT(bench_ratings)],
+                    bench_genres[bench_random() % BENCH_COUNT(bench_genres)],
+                    60 + bench_random() % 180,
+                    (10 + bench_random() % 90) / 10.0);
+            break;
+    }
+}
+
+static double bench_parser(FILE* input, long* films, long* rejected)
+{
+    Parser parser;
+    FilmRecord record;
+    long checksum = 0;
+
+    rewind(input);
+    parser_init(&parser, input, NULL);
+    *films = 0;
+
+    double start = mvdb_now();
+
+    while (parser_next(&parser, &record))
+    {
+        checksum += record.year;
+        (*films)++;
+    }
+
+    double seconds = mvdb_now() - start;
+
+    *rejected = parser.rejected;
+    parser_free(&parser);
+
+    if (checksum == 42)
+    {
+        printf("\n");
+    }
+
+    return seconds;
+}
+
+static void bench_parse(int count)
+{
+    FILE* input = tmpfile();
+    FILE* stray = tmpfile();
+
+    if (input == NULL || stray == NULL)
+    {
+        perror("Error: unable to create the parse benchmark input");
+        exit(EXIT_FAILURE);
+    }
+
+    bench_state = BENCH_SEED;
+
+    for (int row = 0; row < count; row++)
+    {
+        bench_dirtyRow(input, row);
+    }
+
+    bench_state = BENCH_SEED;
+    fprintf(stray, "\"Stray, quote,1999,\"PG\",\"Drama\",100,7.0\n");
+
+    for (int row = 0; row < count; row++)
+    {
+        bench_dirtyRow(stray, row);
+    }
+
+    double megabytes = ftell(input) / 1e6;
+    char line[255];
+    char title[100], rating[50], genre[100];
+    int year, length;
+    float reviewRating;
+    long films = 0;
+    long checksum = 0;
+
+    rewind(input);
+    double start = mvdb_now();
+
+    while (fgets(line, 255, input) != NULL)
+    {
+        sscanf(line, "\"%99[^\",]\",%d,\"%49[^\",]\",\"%99[^\",]\",%d,%f\n",
+                title, &year, rating, genre, &length, &reviewRating);
+        checksum += year;
+        films++;
+    }
+
+    double legacy = mvdb_now() - start;
+
+    printf("parse: %d dirty rows, %.1f MB\n", count, megabytes);
+    printf("  sscanf  %8.1f ms %8.1f MB/s  %8ld films (no rows rejected)\n",
+            legacy * 1e3, megabytes / legacy, films);
+
+    long rejected;
+    double parsed = bench_parser(input, &films, &rejected);
+
+    printf("  parser  %8.1f ms %8.1f MB/s  %8ld films, %ld rows rejected\n",
+            parsed * 1e3, megabytes / parsed, films, rejected);
+
+    double strayed = bench_parser(stray, &films, &rejected);
+
+    printf("  parser  %8.1f ms %8.1f MB/s  %8ld films, %ld rows rejected, "
+            "after a stray quote (%.1fx)\n", strayed * 1e3,
+            megabytes / strayed, films, rejected, strayed / parsed);
+
+    fclose(input);
+    fclose(stray);
+
+    if (checksum == 42)
+    {
+        printf("\n");
+    }
+}
+
+/*
+ * Upsert section: loads a catalogue with list_upsert, loads it again as an
+ * update, then appends two copies of it blindly and removes the duplicates
+ * with list_dedupe. Lookups by key are timed against a walk of the list.
+ */
+static void bench_freeList(List* list)
+{
+    while (list_begin(list) != list_end(list))
+    {
+        film_free(list_head(list));
+    }
+
+    list_free(list);
+}
+
+static Film* bench_scan(List* list, const char* title, int year)
+{
+    for (Iterator i = list_begin(list); i != list_end(list);
+            i = iterator_next(i))
+    {
+        Film* film = iterator_value(i);
+
+        if (film_getYear(film) == year && strcmp(film_getTitle(film), title) == 0)
+        {
+            return film;
+        }
+    }
+
+    return NULL;
+}
+
+static void bench_upsert(int count)
+{
+    List* list = list_new();
+    Film** films = bench_films(count);
+    int added = 0;
+
+    double start = mvdb_now();
+
+    for (int i = 0; i < count; i++)
+    {
+        added += list_upsert(list, films[i], LIST_REPLACE);
+    }
+
+    double load = mvdb_now() - start;
+
+    int lookups = 1000;
+    char* titles[1000];
+    int years[1000];
+    int found = 0;
+
+    int probes = 0;
+    int step = added / lookups > 0 ? added / lookups : 1;
+    int n = 0;
+
+    /* Probe keys spread along the list, copied as upserts free films */
+    for (Iterator i = list_begin(list); i != list_end(list) && probes < lookups;
+            i = iterator_next(i), n++)
+    {
+        if (n % step == 0)
+        {
+            titles[probes] = strdup(film_getTitle(iterator_value(i)));
+            years[probes++] = film_getYear(iterator_value(i));
+        }
+    }
+
+    lookups = probes;
+
+    free(films);
+    films = bench_films(count);
+    int updated = 0;
+
+    start = mvdb_now();
+
+    for (int i = 0; i < count; i++)
+    {
+        updated += !list_upsert(list, films[i], LIST_MERGE);
+    }
+
+    double reload = mvdb_now() - start;
+
+    printf("upsert: %d films, %d distinct (title, year) keys\n", count, added);
+    printf("  load     %8.1f ms  %8.2f Mfilms/s\n", load * 1e3,
+            count / load / 1e6);
+    printf("  reload   %8.1f ms  %8.2f Mfilms/s  %d updated, %d films held\n",
+            reload * 1e3, count / reload / 1e6, updated, list_length(list));
+
+    start = mvdb_now();
+
+    for (int p = 0; p < lookups; p++)
+    {
+        found += bench_scan(list, titles[p], years[p]) != NULL;
+    }
+
+    double scan = mvdb_now() - start;
+
+    start = mvdb_now();
+
+    for (int p = 0; p < lookups; p++)
+    {
+        found += list_find(list, titles[p], years[p]) != NULL;
+    }
+
+    double find = mvdb_now() - start;
+
+    printf("  lookup   %8.0f ns by walking the list, %.0f ns by index "
+            "(%d/%d found)\n", scan * 1e9 / lookups, find * 1e9 / lookups,
+            found, lookups * 2);
+
+    /* A renamed film is found under its new key and forgotten once deleted */
+    Film* renamed = iterator_value(list_begin(list));
+    char* oldTitle = strdup(film_getTitle(renamed));
+    int year = film_getYear(renamed);
+    int rekeyed;
+
+    film_setTitle(renamed, "Renamed by the benchmark");
+    film_setRating(renamed, "R");
+    rekeyed = list_find(list, "Renamed by the benchmark", year) == renamed
+            && list_find(list, oldTitle, year) == NULL;
+    list_deleteRFilms(list);
+    rekeyed = rekeyed
+            && list_find(list, "Renamed by the benchmark", year) == NULL;
+
+    printf("  rename   %s\n", rekeyed ? "re-keyed, gone once deleted"
+            : "left under its old key");
+    free(oldTitle);
+
+    for (int p = 0; p < lookups; p++)
+    {
+        free(titles[p]);
+    }
+
+    free(films);
+    bench_freeList(list);
+
+    list = list_new();
+    films = bench_films(count);
+
+    for (int i = 0; i < count; i++)
+    {
+        list_add(list, films[i]);
+    }
+
+    free(films);
+    films = bench_films(count);
+
+    for (int i = 0; i < count; i++)
+    {
+        list_add(list, films[i]);
+    }
+
+    free(films);
+    start = mvdb_now();
+    int removed = list_dedupe(list, LIST_MERGE);
+    double dedupe = mvdb_now() - start;
+
+    printf("  dedupe   %8.1f ms  %8.2f Mfilms/s  %d removed, %d films held"
+            "  %s\n", dedupe * 1e3, count * 2 / dedupe / 1e6, removed,
+            list_length(list), list_length(list) == added
+            ? "agrees with upsert" : "DIFFERS FROM UPSERT");
+
+    bench_freeList(list);
+}
+
+/*
+ * Journal section: a stream of review rating changes, each followed by a
+ * query for the ten highest rated films and the 10th highest rated Sci-Fi,
+ * answered by views kept up to date from the journal and by re-sorting the
+ * whole collection after every change.
+ */
+static Film** bench_order;
+
+static int bench_byReview(const void* a, const void* b)
+{
+    int i = *(const int*)a;
+    int j = *(const int*)b;
+    float x = film_getReviewRating(bench_order[i]);
+    float y = film_getReviewRating(bench_order[j]);
+
+    if (x != y)
+    {
+        return x < y ? 1 : -1;
+    }
+
+    return i - j;
+}
+
+static void bench_resort(Film** films, int* order, int count)
+{
+    bench_order = films;
+
+    for (int i = 0; i < count; i++)
+    {
+        order[i] = i;
+    }
+
+    qsort(order, count, sizeof(int), bench_byReview);
+}
+
+static void bench_journal(int count)
+{
+    Film** films = bench_films(count);
+    int* order = (int*)mvdb_alloc(count * sizeof(int));
+    List* list = list_new();
+    Film* top[10];
+    int updates = count;
+    int resorts = 20;
+    long checksum = 0;
+
+    bench_fill(list, films, count);
+
+    double start = mvdb_now();
+    View* rated = view_new(list, VIEW_HIGHEST_RATED, NULL);
+    View* sciFi = view_new(list, VIEW_HIGHEST_RATED, "Sci-Fi");
+    View* noir = view_new(list, VIEW_LONGEST, "Film-Noir");
+    View* shortest = view_new(list, VIEW_SHORTEST_TITLE, NULL);
+    double build = mvdb_now() - start;
+
+    start = mvdb_now();
+
+    for (int u = 0; u < updates; u++)
+    {
+        film_setReviewRating(films[bench_random() % count],
+                (10 + bench_random() % 90) / 10.0f);
+        checksum += view_top(rated, top, 10);
+        checksum += view_at(sciFi, 9) != NULL;
+    }
+
+    double incremental = mvdb_now() - start;
+
+    start = mvdb_now();
+
+    for (int u = 0; u < resorts; u++)
+    {
+        film_setReviewRating(films[bench_random() % count],
+                (10 + bench_random() % 90) / 10.0f);
+        bench_resort(films, order, count);
+        checksum += order[0];
+    }
+
+    double resorted = mvdb_now() - start;
+
+    int agree = view_top(rated, top, 10) == (count < 10 ? count : 10);
+
+    for (int i = 0; i < 10 && i < count; i++)
+    {
+        agree &= top[i] == films[order[i]];
+    }
+
+    printf("journal: %d films, 4 views built in %.1f ms\n", count,
+            build * 1e3);
+    printf("  views    %10.2f us per rating change and query\n",
+            incremental * 1e6 / updates);
+    printf("  re-sort  %10.2f us per rating change and query  %s\n",
+            resorted * 1e6 / resorts,
+            agree ? "top 10 agrees" : "TOP 10 DIFFERS");
+
+    list_deleteRFilms(list);
+    printf("  after deleting R films: %d films, %d in view, %d Sci-Fi, "
+            "%d Film-Noir, shortest title '%s'\n", list_length(list),
+            view_size(rated), view_size(sciFi), view_size(noir),
+            view_size(shortest) > 0
+            ? film_getTitle(view_at(shortest, 0)) : "");
+
+    view_free(rated);
+    view_free(sciFi);
+    view_free(noir);
+    view_free(shortest);
+
+    while (list_begin(list) != list_end(list))
+    {
+        film_free(list_head(list));
+    }
+
+    list_free(list);
+    free(films);
+    free(order);
+
+    if (checksum == 42)
+    {
+        printf("\n");
+    }
+}
+
+/*
+ * Catalogue section: the same films, in year order as an archive would keep
+ * them, saved as films.txt and as films.mvc. Both are read back in full, then
+ * the catalogue is read with filters that let it skip blocks.
+ */
+static int bench_byYear(const void* a, const void* b)
+{
+    return film_getYear(*(Film* const*)a) - film_getYear(*(Film* const*)b);
+}
+
+static void bench_catalogueRead(Catalogue* catalogue, const char* name,
+        const CatalogueFilter* filter)
+{
+    double start = mvdb_now();
+    List* list = catalogue_read(catalogue, filter);
+    double read = mvdb_now() - start;
+
+    printf("  %-22s %8.1f ms  %8d films  %5d blocks read, %5d skipped\n",
+            name, read * 1e3, list_length(list), catalogue->blocksRead,
+            catalogue->blocksSkipped);
+
+    while (list_begin(list) != list_end(list))
+    {
+        film_free(list_head(list));
+    }
+
+    list_free(list);
+}
+
+static void bench_catalogue(int count)
+{
+    Film** films = bench_films(count);
+    FILE* text = tmpfile();
+    FILE* packed = tmpfile();
+
+    if (text == NULL || packed == NULL)
+    {
+        perror("Error: unable to create the catalogue benchmark files");
+        exit(EXIT_FAILURE);
+    }
+
+    qsort(films, count, sizeof(Film*), bench_byYear);
+
+    CatalogueWriter* writer = catalogue_writer(packed, CATALOGUE_BLOCK);
+
+    for (int i = 0; i < count; i++)
+    {
+        film_write(text, films[i]);
+        catalogue_add(writer, films[i]);
+    }
+
+    catalogue_finish(writer);
+    fflush(text);
+
+    long textSize = ftell(text);
+    long packedSize = ftell(packed);
+
+    printf("catalogue: %d films, films.txt %.1f MB, films.mvc %.1f MB "
+            "(%.1fx smaller)\n", count, textSize / 1e6, packedSize / 1e6,
+            (double)textSize / packedSize);
+
+    Parser parser;
+    FilmRecord record;
+    List* list = list_new();
+
+    rewind(text);
+    parser_init(&parser, text, NULL);
+
+    double start = mvdb_now();
+
+    while (parser_next(&parser, &record))
+    {
+        list_add(list, film_fromRecord(&record));
+    }
+
+    double csv = mvdb_now() - start;
+
+    parser_free(&parser);
+    printf("  %-22s %8.1f ms  %8d films\n", "films.txt, parsed", csv * 1e3,
+            list_length(list));
+
+    while (list_begin(list) != list_end(list))
+    {
+        film_free(list_head(list));
+    }
+
+    list_free(list);
+
+    Catalogue* catalogue = catalogue_open(packed);
+    CatalogueFilter filter;
+
+    catalogue_filterAll(&filter);
+    bench_catalogueRead(catalogue, "films.mvc, everything", &filter);
+
+    filter.yearMin = 2000;
+    bench_catalogueRead(catalogue, "year >= 2000", &filter);
+
+    catalogue_filterAll(&filter);
+    filter.genre = "Film-Noir";
+    bench_catalogueRead(catalogue, "genre has Film-Noir", &filter);
+
+    filter.yearMin = 1950;
+    filter.yearMax = 1959;
+    bench_catalogueRead(catalogue, "Film-Noir of the 1950s", &filter);
+
+    catalogue_close(catalogue);
+    fclose(text);
+    fclose(packed);
+    bench_freeFilms(films, count);
+}
+
+/*
+ * Loader section: the dirty rows of the parse section loaded by
+ * list_populateRejects and by the pipelined loader, from a warm and from a
+ * cold page cache. Both must keep the same films and reject the same rows.
+ */
+static long bench_load(FILE* input, FILE* rejects, int pipelined, int cold,
+        List** list, LoaderStats* stats)
+{
+    rewind(input);
+    rewind(rejects);
+
+    if (cold)
+    {
+        fsync(fileno(input));
+        loader_evict(input);
+    }
+
+    double start = mvdb_now();
+
+    *list = pipelined ? loader_populate(input, rejects, stats)
+            : list_populateRejects(input, rejects);
+
+    double load = mvdb_now() - start;
+
+    printf("\n");
+    fflush(rejects);
+
+    return (long)(load * 1e6);
+}
+
+static void bench_freeLoaded(List* list)
+{
+    while (list_begin(list) != list_end(list))
+    {
+        film_free(list_head(list));
+    }
+
+    list_free(list);
+}
+
+static int bench_sameFiles(FILE* a, FILE* b)
+{
+    int x;
+    int y;
+
+    rewind(a);
+    rewind(b);
+
+    do
+    {
+        x = fgetc(a);
+        y = fgetc(b);
+    }
+    while (x == y && x != EOF);
+
+    return x == y;
+}
+
+static void bench_loader(int count)
+{
+    FILE* input = tmpfile();
+    FILE* serialRejects = tmpfile();
+    FILE* pipelinedRejects = tmpfile();
+
+    if (input == NULL || serialRejects == NULL || pipelinedRejects == NULL)
+    {
+        perror("Error: unable to create the loader benchmark files");
+        exit(EXIT_FAILURE);
+    }
+
+    bench_state = BENCH_SEED;
+
+    for (int row = 0; row < count; row++)
+    {
+        bench_dirtyRow(input, row);
+    }
+
+    fflush(input);
+
+    double megabytes = ftell(input) / 1e6;
+
+    printf("loader: %d dirty rows, %.1f MB\n", count, megabytes);
+
+    for (int cold = 0; cold <= 1; cold++)
+    {
+        List* serial;
+        List* pipelined;
+        LoaderStats stats;
+        long serialTime = bench_load(input, serialRejects, 0, cold, &serial,
+                NULL);
+        long pipelinedTime = bench_load(input, pipelinedRejects, 1, cold,
+                &pipelined, &stats);
+        int same = list_length(serial) == list_length(pipelined)
+                && bench_sameFiles(serialRejects, pipelinedRejects);
+
+        for (Iterator i = list_begin(serial), j = list_begin(pipelined);
+                same && i != list_end(serial);
+                i = iterator_next(i), j = iterator_next(j))
+        {
+            same = strcmp(film_getTitle(iterator_value(i)),
+                    film_getTitle(iterator_value(j))) == 0;
+        }
+
+        printf("  %s cache: serial %8.1f ms, pipelined %8.1f ms  %s\n",
+                cold ? "cold" : "warm", serialTime / 1e3, pipelinedTime / 1e3,
+                same ? "same films and rejects" : "RESULTS DIFFER");
+        loader_print(&stats);
+
+        bench_freeLoaded(serial);
+        bench_freeLoaded(pipelined);
+    }
+
+    fclose(input);
+    fclose(serialRejects);
+    fclose(pipelinedRejects);
+}
+
+/*
+ * Traverse section: walks the same films through an array, through a copy of
+ * the old list layout (a malloc'd node per film, allocated between the films
+ * as list_populate used to) and through the unrolled list, with the hardware
+ * cache miss counters read around each walk where the kernel provides them.
+ */
+typedef struct _BenchNode
+{
+    Film* value;
+    struct _BenchNode* next;
+}BenchNode;
+
+typedef enum _BenchWalk
+{
+    BENCH_ARRAY,
+    BENCH_NODES,
+    BENCH_BLOCKS
+}BenchWalk;
+
+typedef struct _BenchCounters
+{
+    int llc;
+    int l1d;
+}BenchCounters;
+
+static int bench_counterOpen(unsigned int type, unsigned long long config)
+{
+#ifdef __linux__
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.type = type;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return -1;
+#endif
+}
+
+static void bench_counterStart(int counter)
+{
+#ifdef __linux__
+    if (counter >= 0)
+    {
+        ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+static long long bench_counterStop(int counter)
+{
+    long long value = -1;
+
+#ifdef __linux__
+    if (counter >= 0)
+    {
+        ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+
+        if (read(counter, &value, sizeof(value)) != sizeof(value))
+        {
+            value = -1;
+        }
+    }
+#endif
+
+    return value;
+}
+
+/*
+ * One walk over every film. With year set it reads each film's year, as a
+ * search does; otherwise it only touches the film pointers.
+ */
+static long bench_walk(BenchWalk walk, Film** films, int count,
+        BenchNode* nodes, List* list, int year)
+{
+    long sum = 0;
+
+    switch (walk)
+    {
+        case BENCH_ARRAY:
+            for (int i = 0; i < count; i++)
+            {
+                sum += year ? film_getYear(films[i]) : (long)(size_t)films[i];
+            }
+            break;
+
+        case BENCH_NODES:
+            for (BenchNode* node = nodes; node != NULL; node = node->next)
+            {
+                sum += year ? film_getYear(node->value)
+                        : (long)(size_t)node->value;
+            }
+            break;
+
+        case BENCH_BLOCKS:
+            for (Iterator i = list_begin(list); i != list_end(list);
+                    i = iterator_next(i))
+            {
+                sum += year ? film_getYear(iterator_value(i))
+                        : (long)(size_t)iterator_value(i);
+            }
+            break;
+    }
+
+    return sum;
+}
+
+static void bench_misses(long long misses, int count)
+{
+    if (misses < 0)
+    {
+        printf(" %13s", "n/a");
+    }
+    else
+    {
+        printf(" %13.3f", (double)misses / count);
+    }
+}
+
+static void bench_traverse(int count)
+{
+    Film** films = (Film**)mvdb_alloc(count * sizeof(Film*));
+    BenchNode** nodes = (BenchNode**)mvdb_alloc(count * sizeof(BenchNode*));
+    List* list = list_new();
+    const char* names[] = { "array", "node per film", "unrolled list" };
+    BenchCounters counters;
+    long checksum = 0;
+
+    bench_state = BENCH_SEED;
+
+    for (int i = 0; i < count; i++)
+    {
+        films[i] = bench_film();
+        nodes[i] = (BenchNode*)mvdb_alloc(sizeof(BenchNode));
+
+        nodes[i]->value = films[i];
+        nodes[i]->next = NULL;
+
+        if (i > 0)
+        {
+            nodes[i - 1]->next = nodes[i];
+        }
+
+        list_add(list, films[i]);
+    }
+
+#ifdef __linux__
+    counters.llc = bench_counterOpen(PERF_TYPE_HARDWARE,
+            PERF_COUNT_HW_CACHE_MISSES);
+    counters.l1d = bench_counterOpen(PERF_TYPE_HW_CACHE,
+            PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#else
+    counters.llc = counters.l1d = -1;
+#endif
+
+    printf("traverse: %d films, unrolled blocks of %d\n", count, LIST_SLOTS);
+
+    if (counters.llc < 0 && counters.l1d < 0)
+    {
+        printf("  (no hardware cache counters here, misses not measured)\n");
+    }
+
+    printf("  %-22s %9s %13s %13s\n", "walk", "ns/film", "LLC miss/film",
+            "L1D miss/film");
+
+    for (int year = 0; year <= 1; year++)
+    {
+        for (int w = BENCH_ARRAY; w <= BENCH_BLOCKS; w++)
+        {
+            double best = 0;
+            long long llc = -1;
+            long long l1d = -1;
+
+            /* Best of five, counting the misses of the fastest walk */
+            for (int run = 0; run < 5; run++)
+            {
+                bench_counterStart(counters.llc);
+                bench_counterStart(counters.l1d);
+                double start = mvdb_now();
+                checksum += bench_walk((BenchWalk)w, films, count, nodes[0],
+                        list, year);
+                double seconds = mvdb_now() - start;
+                long long runLlc = bench_counterStop(counters.llc);
+                long long runL1d = bench_counterStop(counters.l1d);
+
+                if (run == 0 || seconds < best)
+                {
+                    best = seconds;
+                    llc = runLlc;
+                    l1d = runL1d;
+                }
+            }
+
+            char name[40];
+
+            snprintf(name, sizeof(name), "%s%s", names[w],
+                    year ? " + year" : "");
+            printf("  %-22s %9.2f", name, best * 1e9 / count);
+            bench_misses(llc, count);
+            bench_misses(l1d, count);
+            printf("\n");
+        }
+    }
+
+    printf("  list memory: %d bytes/film in nodes before malloc's own, "
+            "%.1f in full blocks\n", (int)sizeof(BenchNode),
+            (double)LIST_BLOCK / LIST_SLOTS);
+
+#ifdef __linux__
+    if (counters.llc >= 0)
+    {
+        close(counters.llc);
+    }
+    if (counters.l1d >= 0)
+    {
+        close(counters.l1d);
+    }
+#endif
+
+    for (int i = 0; i < count; i++)
+    {
+        free(nodes[i]);
+    }
+
+    list_clear(list);
+    free(list);
+    free(nodes);
+    bench_freeFilms(films, count);
+
+    if (checksum == 42)
+    {
+        printf("\n");
+    }
+}
+
+/*
+ * Sketch section: dashboard figures from a sketch against the exact answers
+ * from sorting, with the sketch built both by following a list and by four
+ * ingest threads that each sketch a quarter of the films and are merged.
+ */
+#define BENCH_INGEST 4
+
+typedef struct _BenchIngest
+{
+    Film** films;
+    int count;
+    Sketch* sketch;
+}BenchIngest;
+
+static void* bench_ingest(void* argument)
+{
+    BenchIngest* ingest = (BenchIngest*)argument;
+
+    for (int i = 0; i < ingest->count; i++)
+    {
+        sketch_add(ingest->sketch, ingest->films[i]);
+    }
+
+    return NULL;
+}
+
+static int bench_byFloat(const void* a, const void* b)
+{
+    float x = *(const float*)a;
+    float y = *(const float*)b;
+
+    return (x > y) - (x < y);
+}
+
+static int bench_byTitle(const void* a, const void* b)
+{
+    return strcmp(film_getTitle(*(Film* const*)a),
+            film_getTitle(*(Film* const*)b));
+}
+
+/*
+ * Share of the sorted values below value, to set against the quantile asked
+ * for.
+ */
+static double bench_rank(const float* sorted, int count, double value)
+{
+    int low = 0;
+    int high = count;
+
+    while (low < high)
+    {
+        int middle = (low + high) / 2;
+
+        if (sorted[middle] < value)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return (double)low / count;
+}
+
+static void bench_sketch(int count)
+{
+    Film** films = bench_films(count);
+    Film** byTitle = (Film**)mvdb_alloc(count * sizeof(Film*));
+    float* reviews = (float*)mvdb_alloc(count * sizeof(float));
+    float* lengths = (float*)mvdb_alloc(count * sizeof(float));
+    List* list = list_new();
+    BenchIngest ingests[BENCH_INGEST];
+    pthread_t threads[BENCH_INGEST];
+
+    bench_fill(list, films, count);
+
+    double start = mvdb_now();
+    Sketch* followed = sketch_new(list);
+    double built = mvdb_now() - start;
+
+    start = mvdb_now();
+    Sketch* merged = sketch_new(NULL);
+
+    for (int t = 0; t < BENCH_INGEST; t++)
+    {
+        ingests[t].films = films + (long)count * t / BENCH_INGEST;
+        ingests[t].count = (int)((long)count * (t + 1) / BENCH_INGEST
+                - (long)count * t / BENCH_INGEST);
+        ingests[t].sketch = sketch_new(NULL);
+        pthread_create(&threads[t], NULL, bench_ingest, &ingests[t]);
+    }
+
+    for (int t = 0; t < BENCH_INGEST; t++)
+    {
+        pthread_join(threads[t], NULL);
+        sketch_merge(merged, ingests[t].sketch);
+        sketch_free(ingests[t].sketch);
+    }
+
+    double ingested = mvdb_now() - start;
+
+    /* Exact answers, by sorting every value */
+    start = mvdb_now();
+
+    for (int i = 0; i < count; i++)
+    {
+        reviews[i] = film_getReviewRating(films[i]);
+        lengths[i] = film_getLength(films[i]);
+        byTitle[i] = films[i];
+    }
+
+    qsort(reviews, count, sizeof(float), bench_byFloat);
+    qsort(lengths, count, sizeof(float), bench_byFloat);
+    qsort(byTitle, count, sizeof(Film*), bench_byTitle);
+
+    int titles = count > 0;
+
+    for (int i = 1; i < count; i++)
+    {
+        titles += strcmp(film_getTitle(byTitle[i - 1]),
+                film_getTitle(byTitle[i])) != 0;
+    }
+
+    double exact = mvdb_now() - start;
+
+    int queries = 1000;
+    double checksum = 0;
+
+    start = mvdb_now();
+
+    for (int q = 0; q < queries; q++)
+    {
+        checksum += sketch_quantile(merged, FILM_REVIEWRATING, 0.9);
+    }
+
+    double quantile = (mvdb_now() - start) / queries;
+
+    start = mvdb_now();
+
+    for (int q = 0; q < queries; q++)
+    {
+        checksum += sketch_distinct(merged, FILM_TITLE);
+    }
+
+    double distinct = (mvdb_now() - start) / queries;
+
+    printf("sketch: %d films\n", count);
+    printf("  followed list built %8.1f ms, %d ingest threads + merge "
+            "%8.1f ms, exact by sorting %8.1f ms\n", built * 1e3,
+            BENCH_INGEST, ingested * 1e3, exact * 1e3);
+    printf("  query: quantile %.1f us, distinct %.1f us\n", quantile * 1e6,
+            distinct * 1e6);
+    printf("  %-22s %10s %10s %10s %12s\n", "figure", "exact", "followed",
+            "merged", "merged rank");
+
+    struct
+    {
+        const char* name;
+        FilmField field;
+        double q;
+        const float* sorted;
+    }figures[] =
+    {
+        { "review rating median", FILM_REVIEWRATING, 0.5, reviews },
+        { "review rating p90", FILM_REVIEWRATING, 0.9, reviews },
+        { "run time median", FILM_LENGTH, 0.5, lengths },
+        { "run time p90", FILM_LENGTH, 0.9, lengths }
+    };
+
+    for (int f = 0; f < BENCH_COUNT(figures); f++)
+    {
+        double answer = sketch_quantile(merged, figures[f].field, figures[f].q);
+
+        printf("  %-22s %10.1f %10.1f %10.1f %11.3f\n", figures[f].name,
+                figures[f].sorted[(int)(figures[f].q * (count - 1))],
+                sketch_quantile(followed, figures[f].field, figures[f].q),
+                answer, bench_rank(figures[f].sorted, count, answer));
+    }
+
+    printf("  %-22s %10d %10.0f %10.0f\n", "distinct titles", titles,
+            sketch_distinct(followed, FILM_TITLE),
+            sketch_distinct(merged, FILM_TITLE));
+    printf("  %-22s %10d %10.0f %10.0f\n", "distinct genres",
+            BENCH_COUNT(bench_genres), sketch_distinct(followed, FILM_GENRE),
+            sketch_distinct(merged, FILM_GENRE));
+
+    sketch_free(followed);
+    sketch_free(merged);
+    list_free(list);
+    free(byTitle);
+    free(reviews);
+    free(lengths);
+    bench_freeFilms(films, count);
+
+    if (checksum == 42)
+    {
+        printf("\n");
+    }
+}
+
+/*
+ * Search section: a batch of random genre, certificate and range predicates
+ * searched a predicate at a time, as list_searchFilmNoir does, and as one
+ * batch, checking both find the same films in the same order.
+ */
+#define BENCH_PREDICATES 200
+
+static void bench_predicate(SearchPredicate* predicate)
+{
+    int kind = bench_random() % 4;
+
+    search_all(predicate);
+
+    if (kind == 0 || kind == 3)
+    {
+        predicate->genre = bench_genres[bench_random()
+                % BENCH_COUNT(bench_genres)];
+    }
+    if (kind == 1 || kind == 3)
+    {
+        predicate->rating = bench_ratings[bench_random()
+                % BENCH_COUNT(bench_ratings)];
+    }
+    if (kind >= 2)
+    {
+        predicate->yearMin = 1920 + bench_random() % 90;
+        predicate->yearMax = predicate->yearMin + bench_random() % 30;
+        predicate->reviewMin = (10 + bench_random() % 60) / 10.0f;
+    }
+}
+
+static int bench_matches(const SearchPredicate* predicate, const Film* film)
+{
+    return film_getYear(film) >= predicate->yearMin
+            && film_getYear(film) <= predicate->yearMax
+            && film_getLength(film) >= predicate->lengthMin
+            && film_getLength(film) <= predicate->lengthMax
+            && film_getReviewRating(film) >= predicate->reviewMin
+            && film_getReviewRating(film) <= predicate->reviewMax
+            && (predicate->genre == NULL
+                || film_hasGenre(film, predicate->genre))
+            && (predicate->rating == NULL
+                || strcmp(film_getRating(film), predicate->rating) == 0);
+}
+
+static void bench_search(int count)
+{
+    Film** films = bench_films(count);
+    List* list = list_new();
+    SearchPredicate predicates[BENCH_PREDICATES];
+    List* singles[BENCH_PREDICATES];
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    bench_fill(list, films, count);
+
+    for (int p = 0; p < BENCH_PREDICATES; p++)
+    {
+        bench_predicate(&predicates[p]);
+    }
+
+    double start = mvdb_now();
+
+    for (int p = 0; p < BENCH_PREDICATES; p++)
+    {
+        singles[p] = list_new();
+
+        for (Iterator i = list_begin(list); i != list_end(list);
+                i = iterator_next(i))
+        {
+            if (bench_matches(&predicates[p], iterator_value(i)))
+            {
+                list_add(singles[p], iterator_value(i));
+            }
+        }
+    }
+
+    double single = mvdb_now() - start;
+    double rows = (double)count * BENCH_PREDICATES;
+
+    printf("search: %d films, %d predicates\n", count, BENCH_PREDICATES);
+    printf("  one at a time  %8.1f ms  %8.1f M predicate-rows/s\n",
+            single * 1e3, rows / single / 1e6);
+
+    for (int threads = 1; threads <= cores; threads = threads < cores
+            && threads * 2 > cores ? cores : threads * 2)
+    {
+        SearchBatch* batch = search_run(list, predicates, BENCH_PREDICATES,
+                threads);
+        int same = 1;
+
+        for (int p = 0; p < BENCH_PREDICATES && same; p++)
+        {
+            Iterator i = list_begin(singles[p]);
+            Iterator j = list_begin(batch->results[p]);
+
+            for (; i != list_end(singles[p]) && j != list_end(batch->results[p])
+                    && iterator_value(i) == iterator_value(j);
+                    i = iterator_next(i), j = iterator_next(j));
+
+            same = i == list_end(singles[p])
+                    && j == list_end(batch->results[p]);
+        }
+
+        printf("  batch, %2d %-7s %8.1f ms  %8.1f M predicate-rows/s  %s\n",
+                batch->threads, batch->threads == 1 ? "thread" : "threads",
+                batch->seconds * 1e3, batch->rows / batch->seconds / 1e6,
+                same ? "same results" : "RESULTS DIFFER");
+
+        search_free(batch);
+
+        if (threads == cores)
+        {
+            break;
+        }
+    }
+
+    for (int p = 0; p < BENCH_PREDICATES; p++)
+    {
+        list_free(singles[p]);
+    }
+
+    list_free(list);
+    bench_freeFilms(films, count);
+}
+
+/*
+ * Lazy section: the films written out as films.txt and loaded eagerly by
+ * list_populate and lazily by list_populateLazy, each followed by a query
+ * reading only the year and by one reading the genre and run time. Only the
+ * fields a query reads are decoded, so the lazy load pays for the first query
+ * on each field rather than for every field up front.
+ */
+static long bench_lazyYear(List* list)
+{
+    long total = 0;
+
+    for (Iterator i = list_begin(list); i != list_end(list);
+            i = iterator_next(i))
+    {
+        total += film_getYear(iterator_value(i)) >= 1990;
+    }
+
+    return total;
+}
+
+static long bench_lazyGenre(List* list)
+{
+    long total = 0;
+
+    for (Iterator i = list_begin(list); i != list_end(list);
+            i = iterator_next(i))
+    {
+        total += film_hasGenre(iterator_value(i), "Drama")
+                && film_getLength(iterator_value(i)) > 120;
+    }
+
+    return total;
+}
+
+static void bench_lazy(int count)
+{
+    Film** films = bench_films(count);
+    FILE* input = tmpfile();
+
+    if (input == NULL)
+    {
+        perror("Error: unable to create the lazy benchmark file");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        film_write(input, films[i]);
+    }
+
+    fflush(input);
+    printf("lazy: %d films, %.1f MB\n", count, ftell(input) / 1e6);
+
+    long answers[2][2];
+
+    for (int lazy = 0; lazy <= 1; lazy++)
+    {
+        rewind(input);
+
+        double start = mvdb_now();
+        List* list = lazy ? list_populateLazy(input) : list_populate(input);
+        double load = mvdb_now() - start;
+
+        printf("\n");
+        start = mvdb_now();
+        answers[lazy][0] = bench_lazyYear(list);
+
+        double year = mvdb_now() - start;
+
+        start = mvdb_now();
+        answers[lazy][1] = bench_lazyGenre(list);
+
+        double genre = mvdb_now() - start;
+
+        printf("  %-6s load %8.1f ms, year query %7.1f ms, genre and run "
+                "time query %7.1f ms, total %8.1f ms\n",
+                lazy ? "lazy" : "eager", load * 1e3, year * 1e3, genre * 1e3,
+                (load + year + genre) * 1e3);
+
+        bench_freeLoaded(list);
+    }
+
+    printf("  %s\n", answers[0][0] == answers[1][0]
+            && answers[0][1] == answers[1][1]
+            ? "same answers" : "ANSWERS DIFFER");
+
+    fclose(input);
+    bench_freeFilms(films, count);
+}
+
+/*
+ * Memory section: the report's Sci-Fi search repeated three ways: in place
+ * with list_findGenre, through a temporary list freed after each query, and
+ * through temporary lists kept until the end, as the report used to leave
+ * them. The peak resident size is read after each, so they run from the
+ * least memory hungry up.
+ */
+#define BENCH_MEMORY_ROUNDS 200
+
+static long bench_maxResident()
+{
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF, &usage);
+
+    return usage.ru_maxrss;
+}
+
+static void bench_memoryRound(const char* name, List* list, int mode)
+{
+    List* kept[BENCH_MEMORY_ROUNDS];
+    long resident = bench_maxResident();
+    long found = 0;
+    double start = mvdb_now();
+
+    for (int r = 0; r < BENCH_MEMORY_ROUNDS; r++)
+    {
+        if (mode == 0)
+        {
+            for (Iterator i = list_findGenre(list_begin(list), "Sci-Fi");
+                    i != list_end(list);
+                    i = list_findGenre(iterator_next(i), "Sci-Fi"))
+            {
+                found++;
+            }
+        }
+        else
+        {
+            kept[r] = list_searchSciFi(list);
+            found += list_length(kept[r]);
+
+            if (mode == 1)
+            {
+                list_free(kept[r]);
+            }
+        }
+    }
+
+    double seconds = mvdb_now() - start;
+    ListMemory memory = { 0 };
+
+    list_memory(list, &memory);
+    printf("  %-22s %7.2f ms/query, %ld found, results %8.1f KB "
+            "(at most %8.1f KB), peak RSS +%ld KB\n", name,
+            seconds * 1e3 / BENCH_MEMORY_ROUNDS, found / BENCH_MEMORY_ROUNDS,
+            memory.results / 1024.0, memory.peak / 1024.0,
+            bench_maxResident() - resident);
+
+    if (mode == 2)
+    {
+        for (int r = 0; r < BENCH_MEMORY_ROUNDS; r++)
+        {
+            list_free(kept[r]);
+        }
+    }
+}
+
+static void bench_memory(int count)
+{
+    Film** films = bench_films(count);
+    List* list = list_new();
+    ListMemory memory = { 0 };
+
+    bench_fill(list, films, count);
+    list_find(list, film_getTitle(films[0]), film_getYear(films[0]));
+
+    printf("memory: %d films, %d searches each way\n", count,
+            BENCH_MEMORY_ROUNDS);
+    bench_memoryRound("in place", list, 0);
+    bench_memoryRound("temporary list, freed", list, 1);
+    bench_memoryRound("temporary list, kept", list, 2);
+
+    list_memory(list, &memory);
+    list_printMemory(&memory);
+
+    list_free(list);
+    bench_freeFilms(films, count);
+}
+
+/*
+ * Match section: first checks match_token and match_exact, and their scalar
+ * versions, against cases strstr got wrong and cases that put a token across
+ * the 16 and 32 byte vector boundaries, then against each other on random
+ * genres. Then times a genre and a certificate filter over the films against
+ * the strstr filters they replace, counting the films strstr wrongly kept.
+ */
+typedef struct _BenchMatch
+{
+    const char* text;
+    const char* wanted;
+    int matches;
+}BenchMatch;
+
+static const BenchMatch bench_tokenCases[] =
+{
+    { "Crime/Drama", "Drama", 1 },
+    { "Drama/Romance", "Drama", 1 },
+    { "Dramatic/Crime", "Drama", 0 },
+    { "Crime/Docudrama", "Drama", 0 },
+    { "Musical", "Music", 0 },
+    { "Music/Musical", "Musical", 1 },
+    { "Crime/Film-Noir", "Noir", 0 },
+    { "Action/Sci-Fi", "Sci", 0 },
+    { "Action/Sci-Fi", "Sci-Fi", 1 },
+    { "Action/Sci-Fi", "Fi", 0 },
+    { "", "Drama", 0 },
+    { "Drama", "", 1 },
+    { "Drama/", "Drama", 1 },
+    { "ABCDEFGHIJKLMNO/Drama", "Drama", 1 },
+    { "ABCDEFGHIJKLMNOP/Drama", "Drama", 1 },
+    { "ABCDEFGHIJKLMNOPQRSTUVWXYZabcde/Drama", "Drama", 1 },
+    { "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdeDrama", "Drama", 0 },
+    { "Action/Adventure/Animation/Biography/Comedy/Crime/Western", "Crime", 1 },
+    { "Action/Adventure/Animation/Biography/Comedy/Crime/Western", "Western",
+            1 },
+    { "Action/Adventure/Animation/Biography/Comedy/Crime/Western", "West", 0 }
+};
+
+static const BenchMatch bench_exactCases[] =
+{
+    { "R", "R", 1 },
+    { "NOT RATED", "R", 0 },
+    { "APPROVED", "R", 0 },
+    { "UNRATED", "R", 0 },
+    { "PG-13", "PG", 0 },
+    { "PG", "PG-13", 0 },
+    { "PG", "PG", 1 },
+    { "", "R", 0 },
+    { "TV-14", "TV-14", 1 },
+    { "A CERTIFICATE 19", "A CERTIFICATE 19", 1 }
+};
+
+static int bench_checkMatch(const char* kind, const BenchMatch* test,
+        int (*match)(const char*, size_t, const char*), size_t size)
+{
+    char buffer[100] = "";
+
+    strncpy(buffer, test->text, size - 1);
+
+    if (match(buffer, size, test->wanted) != test->matches)
+    {
+        printf("  WRONG: %s(\"%s\", \"%s\") should be %d\n", kind,
+                test->text, test->wanted, test->matches);
+
+        return 0;
+    }
+
+    return 1;
+}
+
+static void bench_match(int count)
+{
+    int right = 0;
+    int checks = 0;
+
+    for (int c = 0; c < BENCH_COUNT(bench_tokenCases); c++)
+    {
+        right += bench_checkMatch("match_token", &bench_tokenCases[c],
+                match_token, sizeof(((Film*)0)->genre));
+        right += bench_checkMatch("match_tokenScalar", &bench_tokenCases[c],
+                match_tokenScalar, sizeof(((Film*)0)->genre));
+        checks += 2;
+    }
+
+    for (int c = 0; c < BENCH_COUNT(bench_exactCases); c++)
+    {
+        right += bench_checkMatch("match_exact", &bench_exactCases[c],
+                match_exact, sizeof(((Film*)0)->rating));
+        right += bench_checkMatch("match_exactScalar", &bench_exactCases[c],
+                match_exactScalar, sizeof(((Film*)0)->rating));
+        checks += 2;
+    }
+
+    /* Random genres, with tokens run together as well as separated */
+    bench_state = BENCH_SEED;
+
+    for (int r = 0; r < 100000; r++)
+    {
+        char genre[100] = "";
+        int tokens = bench_random() % 6;
+        const char* wanted = bench_genres[bench_random()
+                % BENCH_COUNT(bench_genres)];
+
+        for (int t = 0; t < tokens; t++)
+        {
+            strcat(genre, t == 0 || bench_random() % 4 == 0 ? "" : "/");
+            strcat(genre, bench_genres[bench_random()
+                    % BENCH_COUNT(bench_genres)]);
+        }
+
+        right += match_token(genre, sizeof(genre), wanted)
+                == match_tokenScalar(genre, sizeof(genre), wanted);
+        checks++;
+    }
+
+    printf("match: %d of %d checks right\n", right, checks);
+
+    Film** films = bench_films(count);
+    long found[4] = { 0 };
+    double start = mvdb_now();
+
+    for (int i = 0; i < count; i++)
+    {
+        found[0] += strstr(film_getGenre(films[i]), "Crime") != NULL;
+    }
+
+    double genreStrstr = mvdb_now() - start;
+
+    start = mvdb_now();
+
+    for (int i = 0; i < count; i++)
+    {
+        found[1] += film_hasGenre(films[i], "Crime");
+    }
+
+    double genreToken = mvdb_now() - start;
+
+    start = mvdb_now();
+
+    for (int i = 0; i < count; i++)
+    {
+        found[2] += strstr(film_getRating(films[i]), "R") != NULL;
+    }
+
+    double ratingStrstr = mvdb_now() - start;
+
+    start = mvdb_now();
+
+    for (int i = 0; i < count; i++)
+    {
+        found[3] += film_isRRated(films[i]);
+    }
+
+    double ratingExact = mvdb_now() - start;
+
+    printf("  genre \"Crime\"  strstr %7.1f ms, match_token %7.1f ms  "
+            "(%ld kept, %ld by strstr)\n", genreStrstr * 1e3,
+            genreToken * 1e3, found[1], found[0]);
+    printf("  rating \"R\"     strstr %7.1f ms, match_exact %7.1f ms  "
+            "(%ld kept, %ld by strstr)\n", ratingStrstr * 1e3,
+            ratingExact * 1e3, found[3], found[2]);
+
+    bench_freeFilms(films, count);
+}
+
+/*
+ * Pipeline section: queries answered eagerly, by collecting every matching
+ * film into a temporary list as list_searchFilmNoir does and then taking the
+ * first few, and lazily through a pipeline that stops at its limit. The
+ * queries run from unselective (the limit is met almost at once) to very
+ * selective (the whole list is read either way). Then the ten best rated
+ * dramas, by sorting every drama and by a top-k stage.
+ */
+typedef struct _BenchQuery
+{
+    const char* name;
+    const char* genre;
+    const char* rating;
+    int low;
+    int high;
+    int limit;
+}BenchQuery;
+
+static const BenchQuery bench_queries[] =
+{
+    { "first 3 films after 1950", NULL, NULL, 1951, 9999, 3 },
+    { "first 3 Film-Noir after 1950", "Film-Noir", NULL, 1951, 9999, 3 },
+    { "first 100 Drama rated R", "Drama", "R", 0, 9999, 100 },
+    { "first 1000 G Film-Noir 2015-16", "Film-Noir", "G", 2015, 2016, 1000 }
+};
+
+static int bench_queryKeeps(const BenchQuery* query, const Film* film)
+{
+    int year = film_getYear(film);
+
+    return year >= query->low && year <= query->high
+            && (query->genre == NULL || film_hasGenre(film, query->genre))
+            && (query->rating == NULL || film_hasRating(film, query->rating));
+}
+
+static long bench_eagerQuery(List* list, const BenchQuery* query,
+        Film** found)
+{
+    List* matches = list_newTemporary();
+    long count = 0;
+
+    for (Iterator i = list_begin(list); i != list_end(list);
+            i = iterator_next(i))
+    {
+        if (bench_queryKeeps(query, iterator_value(i)))
+        {
+            list_add(matches, iterator_value(i));
+        }
+    }
+
+    for (Iterator i = list_begin(matches); i != list_end(matches)
+            && count < query->limit; i = iterator_next(i))
+    {
+        found[count++] = iterator_value(i);
+    }
+
+    list_free(matches);
+
+    return count;
+}
+
+static long bench_lazyQuery(List* list, const BenchQuery* query,
+        Film** found, long* read)
+{
+    Pipe* pipe = pipe_years(pipe_from(list), query->low, query->high);
+    PipeRow row;
+    long count = 0;
+
+    if (query->genre != NULL)
+    {
+        pipe = pipe_genre(pipe, query->genre);
+    }
+    if (query->rating != NULL)
+    {
+        pipe = pipe_rating(pipe, query->rating);
+    }
+
+    pipe = pipe_limit(pipe_project(pipe, FILM_TITLE), query->limit);
+
+    while (pipe_next(pipe, &row))
+    {
+        found[count++] = row.film;
+    }
+
+    *read = pipe_read(pipe);
+    pipe_free(pipe);
+
+    return count;
+}
+
+typedef struct _BenchRanked
+{
+    Film* film;
+    long seq;
+}BenchRanked;
+
+static int bench_byRatingDown(const void* a, const void* b)
+{
+    const BenchRanked* x = (const BenchRanked*)a;
+    const BenchRanked* y = (const BenchRanked*)b;
+    float p = film_getReviewRating(x->film);
+    float q = film_getReviewRating(y->film);
+
+    if (p != q)
+    {
+        return p < q ? 1 : -1;
+    }
+
+    return (x->seq > y->seq) - (x->seq < y->seq);
+}
+
+static void bench_pipeline(int count)
+{
+    Film** films = bench_films(count);
+    List* list = list_new();
+    Film* eager[1000];
+    Film* lazy[1000];
+
+    bench_fill(list, films, count);
+    printf("pipeline: %d films\n", count);
+
+    for (int q = 0; q < BENCH_COUNT(bench_queries); q++)
+    {
+        const BenchQuery* query = &bench_queries[q];
+        long read;
+        double start = mvdb_now();
+        long eagerCount = bench_eagerQuery(list, query, eager);
+        double eagerTime = mvdb_now() - start;
+
+        start = mvdb_now();
+
+        long lazyCount = bench_lazyQuery(list, query, lazy, &read);
+        double lazyTime = mvdb_now() - start;
+        int same = eagerCount == lazyCount
+                && memcmp(eager, lazy, eagerCount * sizeof(Film*)) == 0;
+
+        printf("  %-30s eager %8.3f ms, pipeline %8.3f ms (%ld films "
+                "read)  %s\n", query->name, eagerTime * 1e3, lazyTime * 1e3,
+                read, same ? "same films" : "FILMS DIFFER");
+    }
+
+    double start = mvdb_now();
+    BenchRanked* ranked = (BenchRanked*)mvdb_alloc(count * sizeof(BenchRanked));
+    long dramas = 0;
+
+    for (Iterator i = list_begin(list); i != list_end(list);
+            i = iterator_next(i))
+    {
+        if (film_hasGenre(iterator_value(i), "Drama"))
+        {
+            ranked[dramas].film = iterator_value(i);
+            ranked[dramas].seq = dramas;
+            dramas++;
+        }
+    }
+
+    qsort(ranked, dramas, sizeof(BenchRanked), bench_byRatingDown);
+
+    double sortTime = mvdb_now() - start;
+
+    start = mvdb_now();
+
+    Pipe* pipe = pipe_top(pipe_genre(pipe_from(list), "Drama"), 10,
+            FILM_REVIEWRATING);
+    PipeRow row;
+    int same = 1;
+
+    for (int k = 0; pipe_next(pipe, &row); k++)
+    {
+        same = same && k < dramas && row.film == ranked[k].film;
+    }
+
+    pipe_free(pipe);
+
+    double topTime = mvdb_now() - start;
+
+    printf("  %-30s sort  %8.3f ms, top-k    %8.3f ms  %s\n",
+            "10 best rated Drama", sortTime * 1e3, topTime * 1e3,
+            same ? "same films" : "FILMS DIFFER");
+
+    free(ranked);
+    list_free(list);
+    bench_freeFilms(films, count);
+}
+
+/*
+ * Similar section: the ten films most like each of BENCH_SIMILAR_QUERIES
+ * films, by working out similar_distance to every film and sorting, and by
+ * similar_top; then the ten most like every film, with similar_all on one
+ * thread and on every core.
+ */
+#define BENCH_SIMILAR_QUERIES 50
+#define BENCH_SIMILAR_K 10
+
+typedef struct _BenchNear
+{
+    float distance;
+    int position;
+}BenchNear;
+
+static int bench_byNear(const void* a, const void* b)
+{
+    const BenchNear* x = (const BenchNear*)a;
+    const BenchNear* y = (const BenchNear*)b;
+
+    if (x->distance != y->distance)
+    {
+        return x->distance < y->distance ? -1 : 1;
+    }
+
+    return (x->position > y->position) - (x->position < y->position);
+}
+
+static void bench_similar(int count)
+{
+    Film** films = bench_films(count);
+    List* list = list_new();
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    bench_fill(list, films, count);
+    printf("similar: %d films, top %d\n", count, BENCH_SIMILAR_K);
+
+    double start = mvdb_now();
+    Similar* index = similar_new(list);
+
+    printf("  index           %8.1f ms  %8.1f KB\n",
+            (mvdb_now() - start) * 1e3, similar_bytes(index) / 1024.0);
+
+    BenchNear* near = (BenchNear*)mvdb_alloc(count * sizeof(BenchNear));
+    SimilarMatch matches[BENCH_SIMILAR_K];
+    double scanTime = 0;
+    double topTime = 0;
+    int same = 1;
+
+    bench_state = BENCH_SEED;
+
+    for (int q = 0; q < BENCH_SIMILAR_QUERIES; q++)
+    {
+        Film* film = films[bench_random() % count];
+        int n = 0;
+
+        start = mvdb_now();
+
+        for (int p = 0; p < index->count; p++)
+        {
+            if (index->films[p] != film)
+            {
+                near[n].distance = similar_distance(index, film,
+                        index->films[p]);
+                near[n].position = p;
+                n++;
+            }
+        }
+
+        qsort(near, n, sizeof(BenchNear), bench_byNear);
+        scanTime += mvdb_now() - start;
+        start = mvdb_now();
+
+        int found = similar_top(index, film, BENCH_SIMILAR_K, matches);
+
+        topTime += mvdb_now() - start;
+        same = same && found == (n < BENCH_SIMILAR_K ? n : BENCH_SIMILAR_K);
+
+        for (int m = 0; m < found; m++)
+        {
+            same = same && matches[m].film == index->films[near[m].position]
+                    && matches[m].distance == near[m].distance;
+        }
+    }
+
+    printf("  one film        scan %8.3f ms, similar_top %8.3f ms  %s\n",
+            scanTime * 1e3 / BENCH_SIMILAR_QUERIES,
+            topTime * 1e3 / BENCH_SIMILAR_QUERIES,
+            same ? "same films" : "FILMS DIFFER");
+
+    start = mvdb_now();
+
+    SimilarMatch* single = similar_all(index, BENCH_SIMILAR_K, 1);
+    double serial = mvdb_now() - start;
+
+    start = mvdb_now();
+
+    SimilarMatch* parallel = similar_all(index, BENCH_SIMILAR_K, cores);
+    double threaded = mvdb_now() - start;
+    int agree = memcmp(single, parallel,
+            (size_t)index->count * BENCH_SIMILAR_K * sizeof(SimilarMatch)) == 0;
+
+    printf("  every film      1 thread  %8.1f ms  %8.1f kfilms/s\n",
+            serial * 1e3, count / serial / 1e3);
+    printf("                  %d threads %8.1f ms  %8.1f kfilms/s  %s\n",
+            cores, threaded * 1e3, count / threaded / 1e3,
+            agree ? "results agree" : "RESULTS DIFFER");
+
+    free(single);
+    free(parallel);
+    free(near);
+    similar_free(index);
+    list_free(list);
+    bench_freeFilms(films, count);
+}
+
+/*
+ * Record and gate modes, run by "make perf-baseline" and "make perf". Each
+ * stage builds its films from the fixed seed, then times one operation on
+ * them, BENCH_GATE_RUNS times. The median CPU time per film, and the median
+ * instructions and cycles per film where the kernel can count them, are
+ * written to the baseline file by record, or compared with it by gate.
+ *
+ * Instructions per film hardly change from run to run, so where they are
+ * counted in both the baseline and this run they are what the gate fails
+ * on, and time and cycles are only shown. Where they are not, the gate
+ * falls back to time per film.
+ */
+#define BENCH_GATE_RUNS 11
+#define BENCH_GATE_EVENTS 2
+
+static const char* bench_eventNames[BENCH_GATE_EVENTS] =
+{
+    "instructions", "cycles"
+};
+
+typedef struct _BenchSample
+{
+    int counters[BENCH_GATE_EVENTS];
+    double start;
+    double seconds;
+    long long events[BENCH_GATE_EVENTS];
+}BenchSample;
+
+static void bench_sampleStart(BenchSample* sample)
+{
+    for (int e = 0; e < BENCH_GATE_EVENTS; e++)
+    {
+        bench_counterStart(sample->counters[e]);
+    }
+
+    sample->start = bench_cpu();
+}
+
+static void bench_sampleStop(BenchSample* sample)
+{
+    sample->seconds = bench_cpu() - sample->start;
+
+    for (int e = 0; e < BENCH_GATE_EVENTS; e++)
+    {
+        sample->events[e] = bench_counterStop(sample->counters[e]);
+    }
+}
+
+static List* bench_gateList(Film** films, int count)
+{
+    List* list = list_new();
+
+    for (int i = 0; i < count; i++)
+    {
+        list_add(list, films[i]);
+    }
+
+    return list;
+}
+
+/*
+ * Load: parses the films from text, as list_populate does, into a list.
+ */
+static void bench_gateLoad(int count, BenchSample* sample)
+{
+    Film** films = bench_films(count);
+    FILE* input = tmpfile();
+    Parser parser;
+    FilmRecord record;
+
+    if (input == NULL)
+    {
+        perror("Error: unable to create the load stage file");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        film_write(input, films[i]);
+    }
+
+    bench_freeFilms(films, count);
+    rewind(input);
+
+    List* list = list_new();
+
+    bench_sampleStart(sample);
+    parser_init(&parser, input, NULL);
+
+    while (parser_next(&parser, &record))
+    {
+        list_add(list, film_fromRecord(&record));
+    }
+
+    parser_free(&parser);
+    bench_sampleStop(sample);
+
+    bench_freeLoaded(list);
+    fclose(input);
+}
+
+static void bench_gateSort(int count, BenchSample* sample)
+{
+    Film** films = bench_films(count);
+    List* list = bench_gateList(films, count);
+
+    bench_sampleStart(sample);
+    list_sortByReviewRating(list);
+    bench_sampleStop(sample);
+
+    list_free(list);
+    bench_freeFilms(films, count);
+}
+
+static void bench_gateSearch(int count, BenchSample* sample)
+{
+    Film** films = bench_films(count);
+    List* list = bench_gateList(films, count);
+    SearchPredicate predicates[32];
+
+    for (int p = 0; p < 32; p++)
+    {
+        bench_predicate(&predicates[p]);
+    }
+
+    bench_sampleStart(sample);
+    search_free(search_run(list, predicates, 32, 1));
+    bench_sampleStop(sample);
+
+    list_free(list);
+    bench_freeFilms(films, count);
+}
+
+/*
+ * Print: formats every film as a line, as film_write and the query server
+ * do, without the cost of the terminal.
+ */
+static void bench_gatePrint(int count, BenchSample* sample)
+{
+    Film** films = bench_films(count);
+    char line[512];
+    long written = 0;
+
+    bench_sampleStart(sample);
+
+    for (int i = 0; i < count; i++)
+    {
+        written += film_toLine(films[i], line, sizeof(line));
+    }
+
+    bench_sampleStop(sample);
+
+    if (written <= 0)
+    {
+        fprintf(stderr, "Error: print stage wrote nothing\n");
+    }
+
+    bench_freeFilms(films, count);
+}
+
+static void bench_gateDelete(int count, BenchSample* sample)
+{
+    Film** films = bench_films(count);
+    List* list = bench_gateList(films, count);
+
+    free(films);
+
+    bench_sampleStart(sample);
+    list_deleteRFilms(list);
+    bench_sampleStop(sample);
+
+    bench_freeLoaded(list);
+}
+
+typedef struct _BenchStage
+{
+    const char* name;
+    void (*run)(int count, BenchSample* sample);
+    int count;
+}BenchStage;
+
+static BenchStage bench_stages[] =
+{
+    { "load", bench_gateLoad, 20000 },
+    { "sort", bench_gateSort, 1000 },
+    { "search", bench_gateSearch, 20000 },
+    { "print", bench_gatePrint, 20000 },
+    { "delete", bench_gateDelete, 100000 }
+};
+
+/*
+ * Per film figures of one stage: the median time in nanoseconds, then the
+ * median of each event, or -1 where it could not be counted.
+ */
+typedef struct _BenchFigures
+{
+    char name[32];
+    double values[1 + BENCH_GATE_EVENTS];
+}BenchFigures;
+
+static int bench_byValue(const void* a, const void* b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+
+    return (x > y) - (x < y);
+}
+
+static double bench_median(double* values)
+{
+    qsort(values, BENCH_GATE_RUNS, sizeof(double), bench_byValue);
+
+    return values[BENCH_GATE_RUNS / 2];
+}
+
+/*
+ * Runs the stages in turn, BENCH_GATE_RUNS times round, rather than one
+ * stage at a time, so a spell of interference from the rest of the machine
+ * is spread over every stage instead of landing on one.
+ */
+static void bench_allFigures(BenchFigures* figures)
+{
+    BenchSample sample = { { -1, -1 }, 0, 0, { 0, 0 } };
+    double runs[BENCH_COUNT(bench_stages)][1 + BENCH_GATE_EVENTS]
+            [BENCH_GATE_RUNS];
+
+#ifdef __linux__
+    sample.counters[0] = bench_counterOpen(PERF_TYPE_HARDWARE,
+            PERF_COUNT_HW_INSTRUCTIONS);
+    sample.counters[1] = bench_counterOpen(PERF_TYPE_HARDWARE,
+            PERF_COUNT_HW_CPU_CYCLES);
+#endif
+
+    for (int r = 0; r < BENCH_GATE_RUNS; r++)
+    {
+        for (int s = 0; s < BENCH_COUNT(bench_stages); s++)
+        {
+            const BenchStage* stage = &bench_stages[s];
+
+            stage->run(stage->count, &sample);
+            runs[s][0][r] = sample.seconds * 1e9 / stage->count;
+
+            for (int e = 0; e < BENCH_GATE_EVENTS; e++)
+            {
+                runs[s][1 + e][r] = sample.events[e] < 0 ? -1
+                        : (double)sample.events[e] / stage->count;
+            }
+        }
+    }
+
+    for (int s = 0; s < BENCH_COUNT(bench_stages); s++)
+    {
+        snprintf(figures[s].name, sizeof(figures[s].name), "%s",
+                bench_stages[s].name);
+
+        for (int v = 0; v < 1 + BENCH_GATE_EVENTS; v++)
+        {
+            figures[s].values[v] = bench_median(runs[s][v]);
+        }
+    }
+
+    for (int e = 0; e < BENCH_GATE_EVENTS; e++)
+    {
+        if (sample.counters[e] >= 0)
+        {
+            close(sample.counters[e]);
+        }
+    }
+}
+
+static int bench_record(const char* path)
+{
+    FILE* output = fopen(path, "w");
+
+    if (output == NULL)
+    {
+        fprintf(stderr, "Error: unable to open '%s' in mode 'w'\n", path);
+
+        return EXIT_FAILURE;
+    }
+
+    BenchFigures figures[BENCH_COUNT(bench_stages)];
+
+    bench_allFigures(figures);
+    fprintf(output, "# stage, then per film: median ns, %s and %s "
+            "(-1 if not counted)\n", bench_eventNames[0], bench_eventNames[1]);
+
+    for (int s = 0; s < BENCH_COUNT(bench_stages); s++)
+    {
+        fprintf(output, "%s %.2f %.2f %.2f\n", figures[s].name,
+                figures[s].values[0], figures[s].values[1],
+                figures[s].values[2]);
+        printf("%-8s %10.2f ns/film\n", figures[s].name, figures[s].values[0]);
+    }
+
+    fclose(output);
+    printf("Baseline written to %s\n", path);
+
+    if (figures[0].values[1] < 0)
+    {
+        printf("Instructions could not be counted here, so make perf will "
+                "gate on time per film only\n");
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*
+ * Whether a stage is gated on instructions rather than time: only if they
+ * were counted both for the baseline and now.
+ */
+static int bench_counted(const BenchFigures* was, const BenchFigures* now)
+{
+    return was->values[1] > 0 && now->values[1] >= 0;
+}
+
+/*
+ * Counts the stages whose gated figure is more than threshold percent above
+ * their line in the baseline, printing each comparison if show is set.
+ * Figures not counted in either are skipped.
+ */
+static int bench_compare(const BenchFigures* baseline, int lines,
+        const BenchFigures* figures, double threshold, int show)
+{
+    int failed = 0;
+
+    for (int s = 0; s < BENCH_COUNT(bench_stages); s++)
+    {
+        const BenchFigures* now = &figures[s];
+        const BenchFigures* was = NULL;
+
+        for (const BenchFigures* line = baseline; line < baseline + lines;
+                line++)
+        {
+            if (strcmp(line->name, now->name) == 0)
+            {
+                was = line;
+            }
+        }
+
+        if (was == NULL)
+        {
+            if (show)
+            {
+                printf("%-8s not in the baseline\n", now->name);
+            }
+
+            continue;
+        }
+
+        int gated = bench_counted(was, now) ? 1 : 0;
+
+        for (int v = 0; v < 1 + BENCH_GATE_EVENTS; v++)
+        {
+            if (was->values[v] <= 0 || now->values[v] < 0)
+            {
+                continue;
+            }
+
+            double change = (now->values[v] / was->values[v] - 1) * 100;
+            int regressed = v == gated && change > threshold;
+            const char* mark = "";
+
+            if (v == gated)
+            {
+                mark = regressed ? "  REGRESSED" : "  gated";
+            }
+
+            if (show)
+            {
+                printf("%-8s %-12s %12.2f %12.2f %+7.1f%%%s\n", now->name,
+                        v == 0 ? "ns" : bench_eventNames[v - 1],
+                        was->values[v], now->values[v], change, mark);
+            }
+
+            failed += regressed;
+        }
+    }
+
+    return failed;
+}
+
+/*
+ * Compares each stage with its line in the baseline. A figure that seems to
+ * have regressed is measured again, and only fails if it is still over the
+ * threshold, so a spell of noise on a shared machine does not fail the gate
+ * on its own.
+ */
+static int bench_gate(const char* path, double threshold)
+{
+    FILE* input = fopen(path, "r");
+    BenchFigures baseline[BENCH_COUNT(bench_stages)];
+    BenchFigures figures[BENCH_COUNT(bench_stages)];
+    int lines = 0;
+    char text[256];
+
+    if (input == NULL)
+    {
+        fprintf(stderr, "Error: no baseline '%s'; run make perf-baseline\n",
+                path);
+
+        return EXIT_FAILURE;
+    }
+
+    while (fgets(text, sizeof(text), input) != NULL
+            && lines < BENCH_COUNT(bench_stages))
+    {
+        BenchFigures* line = &baseline[lines];
+
+        if (text[0] != '#' && sscanf(text, "%31s %lf %lf %lf", line->name,
+                &line->values[0], &line->values[1], &line->values[2]) == 4)
+        {
+            lines++;
+        }
+    }
+
+    fclose(input);
+    bench_allFigures(figures);
+
+    if (bench_compare(baseline, lines, figures, threshold, 0) > 0)
+    {
+        BenchFigures again[BENCH_COUNT(bench_stages)];
+
+        printf("Measuring again to confirm a regression\n");
+        bench_allFigures(again);
+
+        for (int s = 0; s < BENCH_COUNT(bench_stages); s++)
+        {
+            for (int v = 0; v < 1 + BENCH_GATE_EVENTS; v++)
+            {
+                if (again[s].values[v] >= 0
+                        && again[s].values[v] < figures[s].values[v])
+                {
+                    figures[s].values[v] = again[s].values[v];
+                }
+            }
+        }
+    }
+
+    int counted = 1;
+
+    for (int s = 0; s < BENCH_COUNT(bench_stages); s++)
+    {
+        for (int l = 0; l < lines; l++)
+        {
+            if (strcmp(baseline[l].name, figures[s].name) == 0)
+            {
+                counted = counted && bench_counted(&baseline[l], &figures[s]);
+            }
+        }
+    }
+
+    if (counted)
+    {
+        printf("Gating on instructions per film\n");
+    }
+    else
+    {
+        printf("Gating on time per film only: instructions were not counted "
+                "%s\n", figures[0].values[1] < 0 ? "on this machine"
+                : "in the baseline (run make perf-baseline again)");
+    }
+
+    printf("%-8s %-12s %12s %12s %8s\n", "stage", "per film", "baseline",
+            "now", "change");
+
+    int failed = bench_compare(baseline, lines, figures, threshold, 1);
+
+    if (failed > 0)
+    {
+        printf("%d figures regressed by more than %.0f%%\n", failed,
+                threshold);
+
+        return EXIT_FAILURE;
+    }
+
+    printf("No figure regressed by more than %.0f%%\n", threshold);
+
+    return EXIT_SUCCESS;
+}
+
+typedef struct _BenchSection
+{
+    const char* name;
+    void (*run)(int count);
+    int count;
+}BenchSection;
+
+static BenchSection bench_sections[] =
+{
+    { "sort", bench_sort, 3000 },
+    { "groupby", bench_groupby, 1000000 },
+    { "parse", bench_parse, 1000000 },
+    { "upsert", bench_upsert, 1000000 },
+    { "journal", bench_journal, 200000 },
+    { "catalogue", bench_catalogue, 1000000 },
+    { "loader", bench_loader, 1000000 },
+    { "traverse", bench_traverse, 1000000 },
+    { "sketch", bench_sketch, 1000000 },
+    { "search", bench_search, 200000 },
+    { "lazy", bench_lazy, 1000000 },
+    { "memory", bench_memory, 200000 },
+    { "match", bench_match, 1000000 },
+    { "pipeline", bench_pipeline, 1000000 },
+    { "similar", bench_similar, 20000 }
+};
+
+int main(int argc, char** argv)
+{
+    const char* only = argc > 1 ? argv[1] : NULL;
+    int count = argc > 2 ? atoi(argv[2]) : 0;
+    int ran = 0;
+
+    if (argc > 2 && strcmp(argv[1], "record") == 0)
+    {
+        return bench_record(argv[2]);
+    }
+
+    if (argc > 2 && strcmp(argv[1], "gate") == 0)
+    {
+        return bench_gate(argv[2], argc > 3 ? atof(argv[3]) : 10);
+    }
+
+    for (int s = 0; s < BENCH_COUNT(bench_sections); s++)
+    {
+        if (only == NULL || strcmp(only, bench_sections[s].name) == 0)
+        {
+            bench_sections[s].run(count > 0 ? count : bench_sections[s].count);
+            ran++;
+        }
+    }
+
+    if (ran == 0)
+    {
+        fprintf(stderr, "Error: no benchmark section called '%s'\n", only);
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,1048 @@
+/*
+ * File         : catalogue.c
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Source file that implements the films.mvc reader and writer
+ *                described in catalogue.h.
+ *
+ *                A file is laid out as:
+ *                  "MVDBCAT1"
+ *                  block 0, block 1, ...
+ *                  footer: block size, certificate dictionary, genre
+ *                          dictionary, block directory
+ *                  offset of the footer (8 bytes, little endian), "MVDBCAT1"
+ *
+ *                Every number in the footer is a varint; signed ones are
+ *                zigzag encoded first, so the file reads the same on any
+ *                machine.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - Genres match whole tokens.
+ *                19/10/2026 v1.20 - Memory allocated through mvdb.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <float.h>
+
+#include "catalogue.h"
+#include "mvdb.h"
+
+#define CATALOGUE_MAGIC "MVDBCAT1"
+#define CATALOGUE_MAGIC_SIZE 8
+#define CATALOGUE_TRAILER_SIZE 16
+
+typedef struct _CatalogueCursor
+{
+    const unsigned char* p;
+    const unsigned char* end;
+    unsigned long long bits;
+    int bitCount;
+    int bad;
+}CatalogueCursor;
+
+/*
+ * Growable byte buffer the blocks and the footer are encoded into.
+ */
+static void buffer_reserve(CatalogueBuffer* buffer, size_t extra)
+{
+    if (buffer->used + extra > buffer->size)
+    {
+        size_t size = buffer->size == 0 ? 4096 : buffer->size;
+
+        while (size < buffer->used + extra)
+        {
+            size *= 2;
+        }
+
+        buffer->data = (unsigned char*)mvdb_grow(buffer->data, size);
+
+        buffer->size = size;
+    }
+}
+
+static void buffer_put(CatalogueBuffer* buffer, const void* data, size_t size)
+{
+    buffer_reserve(buffer, size);
+    memcpy(buffer->data + buffer->used, data, size);
+    buffer->used += size;
+}
+
+static void buffer_varint(CatalogueBuffer* buffer, unsigned long long value)
+{
+    buffer_reserve(buffer, 10);
+
+    while (value >= 0x80)
+    {
+        buffer->data[buffer->used++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+
+    buffer->data[buffer->used++] = (unsigned char)value;
+}
+
+static unsigned long long catalogue_zigzag(long long value)
+{
+    return ((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63);
+}
+
+static long long catalogue_unzigzag(unsigned long long value)
+{
+    return (long long)(value >> 1) ^ -(long long)(value & 1);
+}
+
+static void buffer_signed(CatalogueBuffer* buffer, long long value)
+{
+    buffer_varint(buffer, catalogue_zigzag(value));
+}
+
+static void buffer_string(CatalogueBuffer* buffer, const char* text)
+{
+    size_t length = strlen(text);
+
+    buffer_varint(buffer, length);
+    buffer_put(buffer, text, length);
+}
+
+/*
+ * Packs count values of width bits each, lowest bits first, and pads the
+ * column to a whole byte.
+ */
+static void buffer_bits(CatalogueBuffer* buffer, const unsigned int* values,
+        int count, int width)
+{
+    unsigned long long bits = 0;
+    int bitCount = 0;
+
+    if (width == 0)
+    {
+        return;
+    }
+
+    buffer_reserve(buffer, ((size_t)count * width + 7) / 8 + 8);
+
+    for (int i = 0; i < count; i++)
+    {
+        bits |= (unsigned long long)values[i] << bitCount;
+        bitCount += width;
+
+        while (bitCount >= 8)
+        {
+            buffer->data[buffer->used++] = (unsigned char)bits;
+            bits >>= 8;
+            bitCount -= 8;
+        }
+    }
+
+    if (bitCount > 0)
+    {
+        buffer->data[buffer->used++] = (unsigned char)bits;
+    }
+}
+
+/*
+ * Number of bits needed to hold every value from 0 to largest.
+ */
+static int catalogue_width(unsigned int largest)
+{
+    int width = 0;
+
+    while (width < 32 && (largest >> width) != 0)
+    {
+        width++;
+    }
+
+    return width;
+}
+
+/*
+ * Tenths of a review rating, rounded to the nearest.
+ */
+static int catalogue_quantize(float reviewRating)
+{
+    double tenths = reviewRating * 10.0;
+
+    if (tenths > INT_MAX / 2)
+    {
+        return INT_MAX / 2;
+    }
+    if (tenths < INT_MIN / 2)
+    {
+        return INT_MIN / 2;
+    }
+
+    return (int)(tenths + (tenths >= 0 ? 0.5 : -0.5));
+}
+
+static float catalogue_review(int tenths)
+{
+    return (float)(tenths / 10.0);
+}
+
+/*
+ * String to id table for the certificate and genre dictionaries.
+ */
+static unsigned int dictionary_hash(const char* text)
+{
+    unsigned int hash = 2166136261u;
+
+    for (; *text != '\0'; text++)
+    {
+        hash = (hash ^ (unsigned char)*text) * 16777619u;
+    }
+
+    return hash;
+}
+
+static void dictionary_place(CatalogueDictionary* dictionary, int id)
+{
+    int i = dictionary_hash(dictionary->names[id]) & dictionary->mask;
+
+    while (dictionary->slots[i] >= 0)
+    {
+        i = (i + 1) & dictionary->mask;
+    }
+
+    dictionary->slots[i] = id;
+}
+
+static unsigned int dictionary_id(CatalogueDictionary* dictionary,
+        const char* text)
+{
+    if (dictionary->slots == NULL)
+    {
+        dictionary->mask = 63;
+        dictionary->slots = (int*)mvdb_alloc(64 * sizeof(int));
+        memset(dictionary->slots, -1, 64 * sizeof(int));
+    }
+
+    int i = dictionary_hash(text) & dictionary->mask;
+
+    for (; dictionary->slots[i] >= 0; i = (i + 1) & dictionary->mask)
+    {
+        if (strcmp(dictionary->names[dictionary->slots[i]], text) == 0)
+        {
+            return dictionary->slots[i];
+        }
+    }
+
+    if (dictionary->count == dictionary->size)
+    {
+        dictionary->size = dictionary->size == 0 ? 16 : dictionary->size * 2;
+        dictionary->names = (char**)mvdb_grow(dictionary->names,
+                dictionary->size * sizeof(char*));
+    }
+
+    int id = dictionary->count++;
+
+    dictionary->names[id] = strdup(text);
+    dictionary->slots[i] = id;
+
+    if (dictionary->count * 2 > dictionary->mask + 1)
+    {
+        int size = (dictionary->mask + 1) * 2;
+
+        free(dictionary->slots);
+        dictionary->slots = (int*)mvdb_alloc(size * sizeof(int));
+        memset(dictionary->slots, -1, size * sizeof(int));
+        dictionary->mask = size - 1;
+
+        for (int d = 0; d < dictionary->count; d++)
+        {
+            dictionary_place(dictionary, d);
+        }
+    }
+
+    return id;
+}
+
+static void dictionary_free(CatalogueDictionary* dictionary)
+{
+    for (int d = 0; d < dictionary->count; d++)
+    {
+        free(dictionary->names[d]);
+    }
+
+    free(dictionary->names);
+    free(dictionary->slots);
+}
+
+static void writer_put(CatalogueWriter* writer, const void* data, size_t size)
+{
+    if (fwrite(data, 1, size, writer->output) != size)
+    {
+        writer->failed = 1;
+    }
+
+    writer->offset += size;
+}
+
+CatalogueWriter* catalogue_writer(FILE* output, int blockSize)
+{
+    CatalogueWriter* writer = (CatalogueWriter*)mvdb_alloc(
+            sizeof(CatalogueWriter));
+
+    writer->output = output;
+    writer->blockSize = blockSize > 0 ? blockSize : CATALOGUE_BLOCK;
+    writer->titleLengths = (int*)mvdb_alloc(writer->blockSize
+            * sizeof(int));
+    writer->years = (int*)mvdb_alloc(writer->blockSize * sizeof(int));
+    writer->lengths = (int*)mvdb_alloc(writer->blockSize * sizeof(int));
+    writer->reviews = (int*)mvdb_alloc(writer->blockSize * sizeof(int));
+    writer->ratings = (unsigned int*)mvdb_alloc(writer->blockSize
+            * sizeof(unsigned int));
+    writer->genres = (unsigned int*)mvdb_alloc(writer->blockSize
+            * sizeof(unsigned int));
+
+    writer_put(writer, CATALOGUE_MAGIC, CATALOGUE_MAGIC_SIZE);
+
+    return writer;
+}
+
+static unsigned char* writer_seen(const unsigned int* ids, int count,
+        int distinct)
+{
+    unsigned char* seen = (unsigned char*)mvdb_alloc((distinct + 7) / 8);
+
+    for (int i = 0; i < count; i++)
+    {
+        seen[ids[i] / 8] |= 1 << (ids[i] % 8);
+    }
+
+    return seen;
+}
+
+static void catalogue_range(int value, int* min, int* max)
+{
+    if (value < *min)
+    {
+        *min = value;
+    }
+    if (value > *max)
+    {
+        *max = value;
+    }
+}
+
+/*
+ * Encodes the films held so far as one block and writes it out.
+ */
+static void writer_flush(CatalogueWriter* writer)
+{
+    int count = writer->count;
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (writer->blockCount == writer->blocksSize)
+    {
+        writer->blocksSize = writer->blocksSize == 0 ? 16
+                : writer->blocksSize * 2;
+        writer->blocks = (CatalogueBlock*)mvdb_grow(writer->blocks,
+                writer->blocksSize * sizeof(CatalogueBlock));
+    }
+
+    CatalogueBlock* block = &writer->blocks[writer->blockCount++];
+    CatalogueBuffer* out = &writer->block;
+
+    memset(block, 0, sizeof(CatalogueBlock));
+    block->count = count;
+    block->yearMin = block->yearMax = writer->years[0];
+    block->lengthMin = block->lengthMax = writer->lengths[0];
+    block->reviewMin = block->reviewMax = writer->reviews[0];
+
+    for (int i = 1; i < count; i++)
+    {
+        catalogue_range(writer->years[i], &block->yearMin, &block->yearMax);
+        catalogue_range(writer->lengths[i], &block->lengthMin,
+                &block->lengthMax);
+        catalogue_range(writer->reviews[i], &block->reviewMin,
+                &block->reviewMax);
+    }
+
+    block->ratingCount = writer->ratingDictionary.count;
+    block->genreCount = writer->genreDictionary.count;
+    block->lengthBits = catalogue_width((unsigned int)block->lengthMax
+            - (unsigned int)block->lengthMin);
+    block->reviewBits = catalogue_width((unsigned int)block->reviewMax
+            - (unsigned int)block->reviewMin);
+    block->ratingBits = catalogue_width(block->ratingCount - 1);
+    block->genreBits = catalogue_width(block->genreCount - 1);
+    block->ratingSeen = writer_seen(writer->ratings, count,
+            block->ratingCount);
+    block->genreSeen = writer_seen(writer->genres, count, block->genreCount);
+
+    out->used = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        buffer_varint(out, writer->titleLengths[i]);
+    }
+
+    buffer_put(out, writer->titles.data, writer->titles.used);
+    buffer_signed(out, writer->years[0]);
+
+    for (int i = 1; i < count; i++)
+    {
+        buffer_signed(out, (long long)writer->years[i] - writer->years[i - 1]);
+    }
+
+    /* Offsets from the block minimum go back into the same arrays */
+    for (int i = 0; i < count; i++)
+    {
+        writer->lengths[i] = (int)((unsigned int)writer->lengths[i]
+                - (unsigned int)block->lengthMin);
+        writer->reviews[i] = (int)((unsigned int)writer->reviews[i]
+                - (unsigned int)block->reviewMin);
+    }
+
+    buffer_bits(out, (unsigned int*)writer->lengths, count, block->lengthBits);
+    buffer_bits(out, (unsigned int*)writer->reviews, count, block->reviewBits);
+    buffer_bits(out, writer->ratings, count, block->ratingBits);
+    buffer_bits(out, writer->genres, count, block->genreBits);
+
+    block->offset = writer->offset;
+    block->size = (int)out->used;
+    writer_put(writer, out->data, out->used);
+
+    writer->count = 0;
+    writer->titles.used = 0;
+}
+
+void catalogue_add(CatalogueWriter* writer, const Film* film)
+{
+    int i = writer->count++;
+    size_t length = strlen(film_getTitle(film));
+
+    buffer_put(&writer->titles, film_getTitle(film), length);
+    writer->titleLengths[i] = (int)length;
+    writer->years[i] = film_getYear(film);
+    writer->lengths[i] = film_getLength(film);
+    writer->reviews[i] = catalogue_quantize(film_getReviewRating(film));
+    writer->ratings[i] = dictionary_id(&writer->ratingDictionary,
+            film_getRating(film));
+    writer->genres[i] = dictionary_id(&writer->genreDictionary,
+            film_getGenre(film));
+
+    if (writer->count == writer->blockSize)
+    {
+        writer_flush(writer);
+    }
+}
+
+int catalogue_finish(CatalogueWriter* writer)
+{
+    CatalogueBuffer footer = { NULL, 0, 0 };
+
+    writer_flush(writer);
+
+    long footerOffset = writer->offset;
+
+    buffer_varint(&footer, writer->blockSize);
+    buffer_varint(&footer, writer->ratingDictionary.count);
+
+    for (int d = 0; d < writer->ratingDictionary.count; d++)
+    {
+        buffer_string(&footer, writer->ratingDictionary.names[d]);
+    }
+
+    buffer_varint(&footer, writer->genreDictionary.count);
+
+    for (int d = 0; d < writer->genreDictionary.count; d++)
+    {
+        buffer_string(&footer, writer->genreDictionary.names[d]);
+    }
+
+    buffer_varint(&footer, writer->blockCount);
+
+    for (int b = 0; b < writer->blockCount; b++)
+    {
+        CatalogueBlock* block = &writer->blocks[b];
+
+        buffer_varint(&footer, block->offset);
+        buffer_varint(&footer, block->size);
+        buffer_varint(&footer, block->count);
+        buffer_signed(&footer, block->yearMin);
+        buffer_signed(&footer, block->yearMax);
+        buffer_signed(&footer, block->lengthMin);
+        buffer_signed(&footer, block->lengthMax);
+        buffer_signed(&footer, block->reviewMin);
+        buffer_signed(&footer, block->reviewMax);
+        buffer_varint(&footer, block->lengthBits);
+        buffer_varint(&footer, block->reviewBits);
+        buffer_varint(&footer, block->ratingBits);
+        buffer_varint(&footer, block->genreBits);
+        buffer_varint(&footer, block->ratingCount);
+        buffer_put(&footer, block->ratingSeen, (block->ratingCount + 7) / 8);
+        buffer_varint(&footer, block->genreCount);
+        buffer_put(&footer, block->genreSeen, (block->genreCount + 7) / 8);
+
+        free(block->ratingSeen);
+        free(block->genreSeen);
+    }
+
+    unsigned char trailer[CATALOGUE_TRAILER_SIZE];
+
+    for (int i = 0; i < 8; i++)
+    {
+        trailer[i] = (unsigned char)((unsigned long long)footerOffset
+                >> (8 * i));
+    }
+
+    memcpy(trailer + 8, CATALOGUE_MAGIC, CATALOGUE_MAGIC_SIZE);
+    writer_put(writer, footer.data, footer.used);
+    writer_put(writer, trailer, sizeof(trailer));
+
+    int failed = writer->failed || fflush(writer->output) != 0;
+
+    free(footer.data);
+    free(writer->titles.data);
+    free(writer->block.data);
+    free(writer->titleLengths);
+    free(writer->years);
+    free(writer->lengths);
+    free(writer->reviews);
+    free(writer->ratings);
+    free(writer->genres);
+    free(writer->blocks);
+    dictionary_free(&writer->ratingDictionary);
+    dictionary_free(&writer->genreDictionary);
+    free(writer);
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int catalogue_writeList(FILE* output, List* list)
+{
+    CatalogueWriter* writer = catalogue_writer(output, CATALOGUE_BLOCK);
+
+    for (Iterator i = list_begin(list); i != list_end(list);
+            i = iterator_next(i))
+    {
+        catalogue_add(writer, iterator_value(i));
+    }
+
+    return catalogue_finish(writer);
+}
+
+/*
+ * Reading. A cursor walks a block or the footer held in memory; running off
+ * the end marks it bad rather than reading past the buffer.
+ */
+static unsigned long long cursor_varint(CatalogueCursor* cursor)
+{
+    unsigned long long value = 0;
+
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (cursor->p == cursor->end)
+        {
+            cursor->bad = 1;
+            return 0;
+        }
+
+        unsigned char byte = *cursor->p++;
+
+        value |= (unsigned long long)(byte & 0x7f) << shift;
+
+        if ((byte & 0x80) == 0)
+        {
+            return value;
+        }
+    }
+
+    cursor->bad = 1;
+
+    return 0;
+}
+
+static long long cursor_signed(CatalogueCursor* cursor)
+{
+    return catalogue_unzigzag(cursor_varint(cursor));
+}
+
+/*
+ * Reads a count that must lie between 0 and limit.
+ */
+static int cursor_count(CatalogueCursor* cursor, long limit)
+{
+    unsigned long long value = cursor_varint(cursor);
+
+    if (value > (unsigned long long)limit)
+    {
+        cursor->bad = 1;
+        return 0;
+    }
+
+    return (int)value;
+}
+
+static const unsigned char* cursor_take(CatalogueCursor* cursor, size_t size)
+{
+    const unsigned char* start = cursor->p;
+
+    if ((size_t)(cursor->end - cursor->p) < size)
+    {
+        cursor->bad = 1;
+        cursor->p = cursor->end;
+
+        return NULL;
+    }
+
+    cursor->p += size;
+
+    return start;
+}
+
+static char* cursor_string(CatalogueCursor* cursor, size_t longest)
+{
+    int length = cursor_count(cursor, (long)longest);
+    const unsigned char* text = cursor_take(cursor, length);
+
+    return text == NULL ? NULL : strndup((const char*)text, length);
+}
+
+static unsigned int cursor_bits(CatalogueCursor* cursor, int width)
+{
+    while (cursor->bitCount < width)
+    {
+        if (cursor->p == cursor->end)
+        {
+            cursor->bad = 1;
+            return 0;
+        }
+
+        cursor->bits |= (unsigned long long)*cursor->p++ << cursor->bitCount;
+        cursor->bitCount += 8;
+    }
+
+    unsigned int value = (unsigned int)(cursor->bits
+            & ((1ull << width) - 1));
+
+    cursor->bits >>= width;
+    cursor->bitCount -= width;
+
+    return value;
+}
+
+static void cursor_align(CatalogueCursor* cursor)
+{
+    cursor->bits = 0;
+    cursor->bitCount = 0;
+}
+
+static char** catalogue_dictionary(CatalogueCursor* cursor, int* count,
+        size_t longest)
+{
+    *count = cursor_count(cursor, cursor->end - cursor->p);
+
+    char** names = (char**)mvdb_alloc(*count * sizeof(char*));
+
+    for (int d = 0; d < *count && !cursor->bad; d++)
+    {
+        names[d] = cursor_string(cursor, longest);
+    }
+
+    return names;
+}
+
+Catalogue* catalogue_open(FILE* input)
+{
+    unsigned char magic[CATALOGUE_MAGIC_SIZE];
+    unsigned char trailer[CATALOGUE_TRAILER_SIZE];
+
+    if (fseek(input, 0, SEEK_SET) != 0
+            || fread(magic, 1, sizeof(magic), input) != sizeof(magic)
+            || memcmp(magic, CATALOGUE_MAGIC, CATALOGUE_MAGIC_SIZE) != 0
+            || fseek(input, 0, SEEK_END) != 0)
+    {
+        return NULL;
+    }
+
+    long end = ftell(input) - CATALOGUE_TRAILER_SIZE;
+
+    if (end < CATALOGUE_MAGIC_SIZE || fseek(input, end, SEEK_SET) != 0
+            || fread(trailer, 1, sizeof(trailer), input) != sizeof(trailer)
+            || memcmp(trailer + 8, CATALOGUE_MAGIC, CATALOGUE_MAGIC_SIZE) != 0)
+    {
+        return NULL;
+    }
+
+    unsigned long long footerOffset = 0;
+
+    for (int i = 0; i < 8; i++)
+    {
+        footerOffset |= (unsigned long long)trailer[i] << (8 * i);
+    }
+
+    if (footerOffset < CATALOGUE_MAGIC_SIZE || footerOffset > (unsigned long
+            long)end || fseek(input, (long)footerOffset, SEEK_SET) != 0)
+    {
+        return NULL;
+    }
+
+    size_t footerSize = end - (long)footerOffset;
+    unsigned char* footer = (unsigned char*)mvdb_alloc(footerSize);
+
+    if (fread(footer, 1, footerSize, input) != footerSize)
+    {
+        free(footer);
+        return NULL;
+    }
+
+    CatalogueCursor cursor = { footer, footer + footerSize, 0, 0, 0 };
+    Catalogue* catalogue = (Catalogue*)mvdb_alloc(sizeof(Catalogue));
+
+    catalogue->input = input;
+    catalogue->blockSize = cursor_count(&cursor, INT_MAX);
+    catalogue->ratings = catalogue_dictionary(&cursor,
+            &catalogue->ratingCount, sizeof(((Film*)0)->rating) - 1);
+    catalogue->genres = catalogue_dictionary(&cursor,
+            &catalogue->genreCount, sizeof(((Film*)0)->genre) - 1);
+    catalogue->blockCount = cursor_count(&cursor, footerSize);
+    catalogue->blocks = (CatalogueBlock*)mvdb_alloc(
+            catalogue->blockCount * sizeof(CatalogueBlock));
+
+    for (int b = 0; b < catalogue->blockCount && !cursor.bad; b++)
+    {
+        CatalogueBlock* block = &catalogue->blocks[b];
+
+        block->offset = cursor_count(&cursor, (long)footerOffset);
+        block->size = cursor_count(&cursor, (long)footerOffset
+                - block->offset);
+        block->count = cursor_count(&cursor, catalogue->blockSize);
+        block->yearMin = (int)cursor_signed(&cursor);
+        block->yearMax = (int)cursor_signed(&cursor);
+        block->lengthMin = (int)cursor_signed(&cursor);
+        block->lengthMax = (int)cursor_signed(&cursor);
+        block->reviewMin = (int)cursor_signed(&cursor);
+        block->reviewMax = (int)cursor_signed(&cursor);
+        block->lengthBits = cursor_count(&cursor, 32);
+        block->reviewBits = cursor_count(&cursor, 32);
+        block->ratingBits = cursor_count(&cursor, 32);
+        block->genreBits = cursor_count(&cursor, 32);
+        block->ratingCount = cursor_count(&cursor, catalogue->ratingCount);
+        block->ratingSeen = (unsigned char*)mvdb_alloc(
+                (block->ratingCount + 7) / 8);
+
+        const unsigned char* seen = cursor_take(&cursor,
+                (block->ratingCount + 7) / 8);
+
+        if (seen != NULL)
+        {
+            memcpy(block->ratingSeen, seen, (block->ratingCount + 7) / 8);
+        }
+
+        block->genreCount = cursor_count(&cursor, catalogue->genreCount);
+        block->genreSeen = (unsigned char*)mvdb_alloc(
+                (block->genreCount + 7) / 8);
+        seen = cursor_take(&cursor, (block->genreCount + 7) / 8);
+
+        if (seen != NULL)
+        {
+            memcpy(block->genreSeen, seen, (block->genreCount + 7) / 8);
+        }
+
+        catalogue->films += block->count;
+    }
+
+    free(footer);
+
+    if (cursor.bad)
+    {
+        catalogue_close(catalogue);
+        return NULL;
+    }
+
+    return catalogue;
+}
+
+void catalogue_filterAll(CatalogueFilter* filter)
+{
+    filter->yearMin = INT_MIN;
+    filter->yearMax = INT_MAX;
+    filter->lengthMin = INT_MIN;
+    filter->lengthMax = INT_MAX;
+    filter->reviewMin = -FLT_MAX;
+    filter->reviewMax = FLT_MAX;
+    filter->genre = NULL;
+    filter->rating = NULL;
+}
+
+/*
+ * Whether any id set in seen is also marked in match.
+ */
+static int catalogue_any(const unsigned char* seen, int count,
+        const unsigned char* match)
+{
+    for (int id = 0; id < count; id++)
+    {
+        if ((seen[id / 8] >> (id % 8) & 1) && match[id])
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static int catalogue_skip(const CatalogueBlock* block,
+        const CatalogueFilter* filter, const unsigned char* ratingMatch,
+        const unsigned char* genreMatch)
+{
+    return block->yearMax < filter->yearMin
+            || block->yearMin > filter->yearMax
+            || block->lengthMax < filter->lengthMin
+            || block->lengthMin > filter->lengthMax
+            || catalogue_review(block->reviewMax) < filter->reviewMin
+            || catalogue_review(block->reviewMin) > filter->reviewMax
+            || (ratingMatch != NULL && !catalogue_any(block->ratingSeen,
+            block->ratingCount, ratingMatch))
+            || (genreMatch != NULL && !catalogue_any(block->genreSeen,
+            block->genreCount, genreMatch));
+}
+
+/*
+ * Decodes one block into columns and adds the films that pass the filter to
+ * list. Returns 0 if the block is damaged.
+ */
+static int catalogue_block(Catalogue* catalogue, const CatalogueBlock* block,
+        const CatalogueFilter* filter, const unsigned char* ratingMatch,
+        const unsigned char* genreMatch, List* list)
+{
+    unsigned char* data = (unsigned char*)mvdb_alloc(block->size);
+    int count = block->count;
+    int* titleLengths = (int*)mvdb_alloc(count * sizeof(int));
+    int* years = (int*)mvdb_alloc(count * sizeof(int));
+    unsigned int* lengths = (unsigned int*)mvdb_alloc(count
+            * sizeof(unsigned int));
+    unsigned int* reviews = (unsigned int*)mvdb_alloc(count
+            * sizeof(unsigned int));
+    unsigned int* ratings = (unsigned int*)mvdb_alloc(count
+            * sizeof(unsigned int));
+    unsigned int* genres = (unsigned int*)mvdb_alloc(count
+            * sizeof(unsigned int));
+    CatalogueCursor cursor = { data, data + block->size, 0, 0, 0 };
+    const unsigned char* text = NULL;
+    size_t textSize = 0;
+    long long year = 0;
+
+    if (fseek(catalogue->input, block->offset, SEEK_SET) != 0
+            || fread(data, 1, block->size, catalogue->input)
+            != (size_t)block->size)
+    {
+        cursor.bad = 1;
+    }
+
+    for (int i = 0; i < count && !cursor.bad; i++)
+    {
+        titleLengths[i] = cursor_count(&cursor, block->size);
+        textSize += titleLengths[i];
+    }
+
+    text = cursor_take(&cursor, textSize);
+
+    for (int i = 0; i < count && !cursor.bad; i++)
+    {
+        year = i == 0 ? cursor_signed(&cursor) : year + cursor_signed(&cursor);
+        years[i] = (int)year;
+    }
+
+    unsigned int* columns[4] = { lengths, reviews, ratings, genres };
+    int widths[4] = { block->lengthBits, block->reviewBits, block->ratingBits,
+            block->genreBits };
+
+    for (int c = 0; c < 4; c++)
+    {
+        cursor_align(&cursor);
+
+        for (int i = 0; i < count && !cursor.bad; i++)
+        {
+            columns[c][i] = widths[c] == 0 ? 0
+                    : cursor_bits(&cursor, widths[c]);
+        }
+    }
+
+    char* title = (char*)mvdb_alloc(1);
+    size_t titleSize = 1;
+
+    for (int i = 0; i < count && !cursor.bad; i++)
+    {
+        int length = (int)((unsigned int)block->lengthMin + lengths[i]);
+        float reviewRating = catalogue_review((int)((unsigned int)
+                block->reviewMin + reviews[i]));
+
+        if (ratings[i] >= (unsigned int)catalogue->ratingCount
+                || genres[i] >= (unsigned int)catalogue->genreCount)
+        {
+            cursor.bad = 1;
+            break;
+        }
+
+        const char* start = (const char*)text;
+
+        text += titleLengths[i];
+
+        if (years[i] < filter->yearMin || years[i] > filter->yearMax
+                || length < filter->lengthMin || length > filter->lengthMax
+                || reviewRating < filter->reviewMin
+                || reviewRating > filter->reviewMax
+                || (ratingMatch != NULL && !ratingMatch[ratings[i]])
+                || (genreMatch != NULL && !genreMatch[genres[i]]))
+        {
+            continue;
+        }
+
+        if ((size_t)titleLengths[i] + 1 > titleSize)
+        {
+            titleSize = titleLengths[i] + 1;
+            free(title);
+            title = (char*)mvdb_alloc(titleSize);
+        }
+
+        memcpy(title, start, titleLengths[i]);
+        title[titleLengths[i]] = '\0';
+        list_add(list, film_new(title, years[i],
+                catalogue->ratings[ratings[i]], catalogue->genres[genres[i]],
+                length, reviewRating));
+    }
+
+    free(title);
+    free(data);
+    free(titleLengths);
+    free(years);
+    free(lengths);
+    free(reviews);
+    free(ratings);
+    free(genres);
+
+    return !cursor.bad;
+}
+
+List* catalogue_read(Catalogue* catalogue, const CatalogueFilter* filter)
+{
+    CatalogueFilter all;
+    unsigned char* ratingMatch = NULL;
+    unsigned char* genreMatch = NULL;
+    List* list = list_new();
+    int intact = 1;
+
+    if (filter == NULL)
+    {
+        catalogue_filterAll(&all);
+        filter = &all;
+    }
+
+    if (filter->rating != NULL)
+    {
+        ratingMatch = (unsigned char*)mvdb_alloc(catalogue->ratingCount);
+
+        for (int id = 0; id < catalogue->ratingCount; id++)
+        {
+            ratingMatch[id] = strcmp(catalogue->ratings[id],
+                    filter->rating) == 0;
+        }
+    }
+
+    if (filter->genre != NULL)
+    {
+        genreMatch = (unsigned char*)mvdb_alloc(catalogue->genreCount);
+
+        for (int id = 0; id < catalogue->genreCount; id++)
+        {
+            genreMatch[id] = match_token(catalogue->genres[id],
+                    strlen(catalogue->genres[id]) + 1, filter->genre);
+        }
+    }
+
+    catalogue->blocksRead = catalogue->blocksSkipped = 0;
+
+    for (int b = 0; b < catalogue->blockCount && intact; b++)
+    {
+        if (catalogue_skip(&catalogue->blocks[b], filter, ratingMatch,
+                genreMatch))
+        {
+            catalogue->blocksSkipped++;
+            continue;
+        }
+
+        catalogue->blocksRead++;
+        intact = catalogue_block(catalogue, &catalogue->blocks[b], filter,
+                ratingMatch, genreMatch, list);
+    }
+
+    free(ratingMatch);
+    free(genreMatch);
+
+    if (!intact)
+    {
+        while (list_begin(list) != list_end(list))
+        {
+            film_free(list_head(list));
+        }
+
+        list_free(list);
+
+        return NULL;
+    }
+
+    return list;
+}
+
+void catalogue_close(Catalogue* catalogue)
+{
+    for (int d = 0; d < catalogue->ratingCount; d++)
+    {
+        free(catalogue->ratings[d]);
+    }
+
+    for (int d = 0; d < catalogue->genreCount; d++)
+    {
+        free(catalogue->genres[d]);
+    }
+
+    for (int b = 0; b < catalogue->blockCount; b++)
+    {
+        free(catalogue->blocks[b].ratingSeen);
+        free(catalogue->blocks[b].genreSeen);
+    }
+
+    free(catalogue->ratings);
+    free(catalogue->genres);
+    free(catalogue->blocks);
+    free(catalogue);
+}
+
+List* list_populateCatalogue(FILE* input)
+{
+    Catalogue* catalogue = catalogue_open(input);
+
+    if (catalogue == NULL)
+    {
+        fprintf(stderr, "Error: not a films.mvc catalogue\n");
+
+        return NULL;
+    }
+
+    List* list = catalogue_read(catalogue, NULL);
+
+    if (list == NULL)
+    {
+        fprintf(stderr, "Error: damaged block in films.mvc catalogue\n");
+    }
+    else
+    {
+        printf("Films successfully read into MVDB: %i", list_length(list));
+    }
+
+    catalogue_close(catalogue);
+
+    return list;
+}
@@ -0,0 +1,289 @@
+/*
+ * File         : catalogue.h
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Header file that defines a compressed, column oriented file
+ *                format for the film collection (films.mvc), as an
+ *                alternative to films.txt.
+ *
+ *                Films are written in blocks of CATALOGUE_BLOCK. Within a
+ *                block each field is stored as its own column:
+ *                  title         - lengths as varints, then the text
+ *                  year          - first year, then the difference from the
+ *                                  previous film, as zigzag varints
+ *                  run time      - offset from the block minimum, bit packed
+ *                  review rating - tenths, offset from the block minimum,
+ *                                  bit packed
+ *                  certificate   - id in a file wide dictionary, bit packed
+ *                  genre         - id in a file wide dictionary, bit packed
+ *
+ *                Review ratings are stored to one decimal place, which is all
+ *                films.txt holds. The dictionaries and a directory of blocks
+ *                are written after the last block. For each block the
+ *                directory keeps the smallest and largest year, run time and
+ *                review rating and which certificates and genres occur in
+ *                it, so a filtered read skips every block that cannot match
+ *                without reading or decoding it.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - Genres match whole tokens.
+ */
+
+#ifndef CATALOGUE_H
+#define CATALOGUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+
+#include "film.h"
+#include "moviedatabase.h"
+
+/*
+ * Films per block when none is given.
+ */
+#define CATALOGUE_BLOCK 4096
+
+/*
+ * Default file name used by main.c.
+ */
+#define CATALOGUE_FILE "films.mvc"
+
+typedef struct _CatalogueBuffer
+{
+    unsigned char* data;
+    size_t used;
+    size_t size;
+}CatalogueBuffer;
+
+typedef struct _CatalogueDictionary
+{
+    char** names;
+    int count;
+    int size;
+    int* slots;
+    int mask;
+}CatalogueDictionary;
+
+/*
+ * Statistics for one block, as held in the directory. Review ratings are in
+ * tenths. ratingSeen and genreSeen are bitmaps over the dictionary ids that
+ * existed when the block was written.
+ */
+typedef struct _CatalogueBlock
+{
+    long offset;
+    int size;
+    int count;
+    int yearMin;
+    int yearMax;
+    int lengthMin;
+    int lengthMax;
+    int reviewMin;
+    int reviewMax;
+    int lengthBits;
+    int reviewBits;
+    int ratingBits;
+    int genreBits;
+    int ratingCount;
+    int genreCount;
+    unsigned char* ratingSeen;
+    unsigned char* genreSeen;
+}CatalogueBlock;
+
+typedef struct _CatalogueWriter
+{
+    FILE* output;
+    int blockSize;
+    int count;
+    long offset;
+    CatalogueBuffer titles;
+    CatalogueBuffer block;
+    int* titleLengths;
+    int* years;
+    int* lengths;
+    int* reviews;
+    unsigned int* ratings;
+    unsigned int* genres;
+    CatalogueDictionary ratingDictionary;
+    CatalogueDictionary genreDictionary;
+    CatalogueBlock* blocks;
+    int blockCount;
+    int blocksSize;
+    int failed;
+}CatalogueWriter;
+
+typedef struct _Catalogue
+{
+    FILE* input;
+    int blockSize;
+    char** ratings;
+    int ratingCount;
+    char** genres;
+    int genreCount;
+    CatalogueBlock* blocks;
+    int blockCount;
+    long films;
+    int blocksRead;
+    int blocksSkipped;
+}Catalogue;
+
+/*
+ * Films a read should keep. Ranges are inclusive; genre keeps films with 
+ * it as one of their genre tokens (as film_hasGenre does) and rating films
+ * with exactly that certificate. NULL strings keep everything.
+ */
+typedef struct _CatalogueFilter
+{
+    int yearMin;
+    int yearMax;
+    int lengthMin;
+    int lengthMax;
+    float reviewMin;
+    float reviewMax;
+    const char* genre;
+    const char* rating;
+}CatalogueFilter;
+
+/*******************************************************************************
+
+Procedure   : catalogue_writer
+
+Parameters  : FILE* output - file opened for writing in binary mode
+              int blockSize - films per block, or 0 for CATALOGUE_BLOCK
+
+Returns     : CatalogueWriter* - a writer ready for catalogue_add
+
+Description : Starts a catalogue. Films are added one at a time, so a
+              catalogue can be written while films.txt streams past.
+
+ ******************************************************************************/
+CatalogueWriter* catalogue_writer(FILE* output, int blockSize);
+
+/*******************************************************************************
+
+Procedure   : catalogue_add
+
+Parameters  : CatalogueWriter* writer - writer from catalogue_writer
+              const Film* film - film to add
+
+Returns     : void
+
+Description : Copies film into the current block, writing the block out once
+              it is full.
+
+ ******************************************************************************/
+void catalogue_add(CatalogueWriter* writer, const Film* film);
+
+/*******************************************************************************
+
+Procedure   : catalogue_finish
+
+Parameters  : CatalogueWriter* writer - writer from catalogue_writer
+
+Returns     : int - EXIT_SUCCESS, or EXIT_FAILURE if a write failed
+
+Description : Writes the last block, the dictionaries and the directory, then
+              frees the writer. Does not close the file.
+
+ ******************************************************************************/
+int catalogue_finish(CatalogueWriter* writer);
+
+/*******************************************************************************
+
+Procedure   : catalogue_writeList
+
+Parameters  : FILE* output - file opened for writing in binary mode
+              List* list - a filled linked list of Film structs
+
+Returns     : int - EXIT_SUCCESS, or EXIT_FAILURE if a write failed
+
+Description : Writes every film in the list, in list order, as a catalogue.
+
+ ******************************************************************************/
+int catalogue_writeList(FILE* output, List* list);
+
+/*******************************************************************************
+
+Procedure   : catalogue_open
+
+Parameters  : FILE* input - file opened for reading in binary mode
+
+Returns     : Catalogue* - the catalogue's dictionaries and directory, or NULL
+                           if input is not a valid catalogue
+
+Description : Reads the end of the file only. Blocks are read by
+              catalogue_read.
+
+ ******************************************************************************/
+Catalogue* catalogue_open(FILE* input);
+
+/*******************************************************************************
+
+Procedure   : catalogue_filterAll
+
+Parameters  : CatalogueFilter* filter - filter to set up
+
+Returns     : void
+
+Description : Sets filter to keep every film, ready for single fields to be
+              narrowed.
+
+ ******************************************************************************/
+void catalogue_filterAll(CatalogueFilter* filter);
+
+/*******************************************************************************
+
+Procedure   : catalogue_read
+
+Parameters  : Catalogue* catalogue - catalogue from catalogue_open
+              const CatalogueFilter* filter - films to keep, or NULL for all
+
+Returns     : List* - a new list of the matching films, in file order
+
+Description : Tests each block's statistics against the filter and reads and
+              decodes only the blocks that may hold a match, then tests each
+              film in them. The number of blocks read and skipped is left in
+              the catalogue. Returns NULL if a block is damaged.
+
+ ******************************************************************************/
+List* catalogue_read(Catalogue* catalogue, const CatalogueFilter* filter);
+
+/*******************************************************************************
+
+Procedure   : catalogue_close
+
+Parameters  : Catalogue* catalogue - catalogue from catalogue_open
+
+Returns     : void
+
+Description : Frees the catalogue. Does not close the file.
+
+ ******************************************************************************/
+void catalogue_close(Catalogue* catalogue);
+
+/*******************************************************************************
+
+Procedure   : list_populateCatalogue
+
+Parameters  : FILE* input - an open films.mvc style file
+
+Returns     : List* - a pointer to a linked list of film structs, or NULL if
+                      input is not a valid catalogue
+
+Description : Stands in for list_populate when the collection has been saved
+              as a catalogue. Reads every film.
+
+ ******************************************************************************/
+List* list_populateCatalogue(FILE* input);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CATALOGUE_H */
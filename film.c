@@ -12,17 +12,31 @@
  * History      : 27/10/2016 v1.00
  *                10/11/2016 v1.10 - Functionality added
  *                16/11/2016 v1.20 - Comments added, code cleaned up.
+ *                19/10/2026 v1.30 - film_toLine added for the query server.
+ *                19/10/2026 v1.40 - film_write added for the streaming report.
+ *                19/10/2026 v1.50 - film_toLine and film_write quote fields as
+ *                                   RFC 4180 does.
+ *                19/10/2026 v1.60 - New films start without a journal.
+ *                19/10/2026 v1.70 - film_newLazy, fields read through the get
+ *                                   methods.
+ *                19/10/2026 v1.80 - Memory allocated through mvdb.h.
+ *                19/10/2026 v1.90 - film_write keeps every digit of the review
+ *                                   rating.
+ *                19/10/2026 v2.00 - film_printFound shared by the list and
+ *                                   stream reports.
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdarg.h>
 #include "film.h"
+#include "mvdb.h"
 
 Film *film_new(char* title, int year, char* rating, char* genre, int length,
         float reviewRating)
 {
-    Film *film = (Film*)malloc(sizeof(Film));
+    Film *film = (Film*)mvdb_alloc(sizeof(Film));
     
     film->title = strdup(title);
     film->year = year;
@@ -30,15 +44,142 @@ Film *film_new(char* title, int year, char* rating, char* genre, int length,
     strcpy(film->genre, genre);
     film->length = length;
     film->reviewRating = reviewRating;
+    film->journal = NULL;
+    film->text = NULL;
+    film->record = NULL;
+    film->decoded = 0;
+    return film;
+}
+
+Film *film_newLazy(FilmText* text, const char* record)
+{
+    Film *film = (Film*)mvdb_alloc(sizeof(Film));
+    
+    film->text = text;
+    film->record = record;
+    text->films++;
     return film;
 }
 
 void film_print(Film* film) 
 {
-    printf("Title: %s\n", film->title);
-    printf("Year: %d\n", film->year);
-    printf("Certificate: %s\n", film->rating);
-    printf("Genre: %s\n", film->genre);
-    printf("Run time: %d\n", film->length);
-    printf("Review Rating: %f\n", film->reviewRating);
-}
\ No newline at end of file
+    printf("Title: %s\n", film_getTitle(film));
+    printf("Year: %d\n", film_getYear(film));
+    printf("Certificate: %s\n", film_getRating(film));
+    printf("Genre: %s\n", film_getGenre(film));
+    printf("Run time: %d\n", film_getLength(film));
+    printf("Review Rating: %f\n", film_getReviewRating(film));
+}
+
+void film_printFound(Film* film, int index)
+{
+    if (film == NULL)
+    {
+        printf("No such film: fewer than %d films\n", index);
+        
+        return;
+    }
+    
+    film_print(film);
+}
+
+/*
+ * Copies text into buffer as a quoted field, doubling any quotes inside it.
+ * Returns the new position even when buffer is full, as snprintf does.
+ */
+static size_t film_quote(char* buffer, size_t size, size_t at, const char* text)
+{
+    if (at < size)
+    {
+        buffer[at] = '"';
+    }
+    at++;
+    
+    for (; *text != '\0'; text++)
+    {
+        if (*text == '"')
+        {
+            if (at < size)
+            {
+                buffer[at] = '"';
+            }
+            at++;
+        }
+        if (at < size)
+        {
+            buffer[at] = *text;
+        }
+        at++;
+    }
+    
+    if (at < size)
+    {
+        buffer[at] = '"';
+    }
+    
+    return at + 1;
+}
+
+/*
+ * snprintf at position at of buffer, returning the new position even when
+ * buffer is full.
+ */
+static size_t film_format(char* buffer, size_t size, size_t at,
+        const char* format, ...)
+{
+    va_list args;
+    
+    va_start(args, format);
+    int length = vsnprintf(at < size ? buffer + at : NULL, 
+            at < size ? size - at : 0, format, args);
+    va_end(args);
+    
+    return at + length;
+}
+
+/*
+ * One films.txt line for film, with the review rating in ratingFormat.
+ */
+static int film_line(const Film* film, char* buffer, size_t size,
+        const char* ratingFormat)
+{
+    size_t at = film_quote(buffer, size, 0, film_getTitle(film));
+    
+    at = film_format(buffer, size, at, ",%d,", film_getYear(film));
+    at = film_quote(buffer, size, at, film_getRating(film));
+    at = film_format(buffer, size, at, ",");
+    at = film_quote(buffer, size, at, film_getGenre(film));
+    at = film_format(buffer, size, at, ",%d,", film_getLength(film));
+    at = film_format(buffer, size, at, ratingFormat,
+            film_getReviewRating(film));
+    
+    if (size > 0 && at >= size)
+    {
+        buffer[size - 1] = '\0';
+    }
+    
+    return (int)at;
+}
+
+int film_toLine(const Film* film, char* buffer, size_t size)
+{
+    return film_line(film, buffer, size, "%.1f\n");
+}
+
+void film_write(FILE* output, const Film* film)
+{
+    char line[512];
+    int length = film_line(film, line, sizeof(line), "%.9g\n");
+    
+    if (length < (int)sizeof(line))
+    {
+        fwrite(line, 1, length, output);
+        return;
+    }
+    
+    char* longLine = (char*)mvdb_alloc(length + 1);
+    
+    film_line(film, longLine, length + 1, "%.9g\n");
+    fwrite(longLine, 1, length, output);
+    free(longLine);
+}
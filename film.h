@@ -13,6 +13,20 @@
  * History      : 27/10/2016 v1.00
  *                10/11/2016 v1.10 - Functionality added
  *                16/11/2016 v1.20 - Comments added, code cleaned up.
+ *                19/10/2026 v1.30 - film_toLine added for the query server.
+ *                19/10/2026 v1.40 - Match helpers added for the streaming report.
+ *                19/10/2026 v1.50 - film_toLine and film_write quote fields as
+ *                                   RFC 4180 does; parsing is in parser.h.
+ *                19/10/2026 v1.60 - Set methods record changes in the journal
+ *                                   of the list holding the film.
+ *                19/10/2026 v1.70 - Fields of lazily loaded films are decoded
+ *                                   by the get methods on first use.
+ *                19/10/2026 v1.80 - Match helpers match whole genre tokens and
+ *                                   exact certificates (see match.h).
+ *                19/10/2026 v1.90 - film_write keeps every digit of the review
+ *                                   rating.
+ *                19/10/2026 v2.00 - film_printFound added.
+ *                19/10/2026 v2.10 - film_measure added.
  */
 
 #ifndef FILM_H
@@ -25,9 +39,32 @@ extern "C" {
 #include <stdio.h>
 #include <stdlib.h>     
 #include <string.h>
+
+#include "match.h"
     
 
         
+/*
+ * Text of a file loaded lazily (see list_populateLazy in parser.h), shared by
+ * the films loaded from it and freed with the last of them. size is the bytes
+ * allocated for data.
+ */
+typedef struct _FilmText
+{
+    char* data;
+    size_t size;
+    long films;
+}FilmText;
+
+/*
+ * journal is the change journal of the list the film is held in, or NULL if
+ * no one is listening for changes to it (see journal.h).
+ *
+ * text is NULL for a film made whole by film_new. For a lazily loaded film it
+ * is the text record points into, and decoded has a bit set, 1 << FilmField,
+ * for each field that has been read out of the record (or set) so far. The
+ * other fields are not filled in until a get method first asks for them.
+ */
 typedef struct FilmStruct
 {
     char* title;
@@ -36,49 +73,118 @@ typedef struct FilmStruct
     char genre[100];
     int length;
     float reviewRating;
+    struct _Journal* journal;
+    FilmText* text;
+    const char* record;
+    unsigned int decoded;
 }Film;
 
+/*
+ * Fields of a film, as named in the change journal.
+ */
+typedef enum _FilmField
+{
+    FILM_TITLE,
+    FILM_YEAR,
+    FILM_RATING,
+    FILM_GENRE,
+    FILM_LENGTH,
+    FILM_REVIEWRATING
+}FilmField;
+
+/*
+ * Defined in journal.c. Records that a field of film has just been changed.
+ */
+void journal_update(struct _Journal* journal, Film* film, FilmField field);
+
+/*
+ * Defined in parser.c. Fills in one field of a lazily loaded film from its
+ * record, gives the length a text field will have once decoded without
+ * decoding it, and lets go of the film's share of its text.
+ */
+void film_decode(Film* film, FilmField field);
+size_t film_measure(const Film* film, FilmField field);
+void film_release(Film* film);
+
+/*
+ * Makes sure field has been decoded. Decoding writes to the film, so a lazily
+ * loaded film must not be read by two threads at once until it is whole.
+ */
+static inline void film_need(const Film *film, FilmField field)
+{
+    if (film->text != NULL && !(film->decoded & (1u << field)))
+    {
+        film_decode((Film*)film, field);
+    }
+}
+
 
 /*
  * Function to free the current film node
  */
 static inline void film_free(Film *film)
 {
+    if (film->text != NULL)
+    {
+        film_release(film);
+    }
+    
+    free(film->title);
     free(film);
     film = NULL;
 }
 
 /*
- * Set methods to alter the state of the Film Structs
+ * Set methods to alter the state of the Film Structs. Each change is recorded
+ * in the film's journal, if it has one.
  */
+static inline void film_changed(Film *film, FilmField field)
+{
+    film->decoded |= 1u << field;
+    
+    if (film->journal != NULL)
+    {
+        journal_update(film->journal, film, field);
+    }
+}
+
 static inline void film_setTitle(Film *film, char* title)
 {
-    strcpy(film->title, title);
+    char* copy = strdup(title);
+    
+    free(film->title);
+    film->title = copy;
+    film_changed(film, FILM_TITLE);
 }
 
 static inline void film_setYear(Film *film, int year)
 {
     film->year = year;
+    film_changed(film, FILM_YEAR);
 }
 
 static inline void film_setRating(Film *film, char* rating)
 {
     strcpy(film->rating, rating);
+    film_changed(film, FILM_RATING);
 }
 
 static inline void film_setGenre(Film *film, char* genre)
 {
     strcpy(film->genre, genre);
+    film_changed(film, FILM_GENRE);
 }
 
 static inline void film_setLength(Film *film, int length)
 {
     film->length = length;
+    film_changed(film, FILM_LENGTH);
 }
 
 static inline void film_setReviewRating(Film *film, float reviewRating)
 {
     film->reviewRating = reviewRating;
+    film_changed(film, FILM_REVIEWRATING);
 }
 
 /*
@@ -87,33 +193,66 @@ static inline void film_setReviewRating(Film *film, float reviewRating)
  */
 static inline const char* const film_getTitle(const Film *film)
 {
+    film_need(film, FILM_TITLE);
+    
     return film->title;
 }
 static inline int film_getYear(const Film *film)
 {
+    film_need(film, FILM_YEAR);
+    
     return film->year;
 }
 
 static inline const char* const film_getRating(const Film *film)
 {
+    film_need(film, FILM_RATING);
+    
     return film->rating;
 }
 
 static inline const char* const film_getGenre(const Film *film)
 {
+    film_need(film, FILM_GENRE);
+    
     return film->genre;
 }
 
 static inline int film_getLength(const Film *film)
 {
+    film_need(film, FILM_LENGTH);
+    
     return film->length;
 }
 
 static inline float film_getReviewRating(const Film *film)
 {
+    film_need(film, FILM_REVIEWRATING);
+    
     return film->reviewRating;
 }
 
+/*
+ * Match helpers shared by every query that filters on genre or certificate,
+ * so the in-memory and streaming reports always agree on what matches. A 
+ * film has a genre when it is one of the "/" separated tokens of its genre,
+ * and a certificate when it is the whole certificate.
+ */
+static inline int film_hasGenre(const Film *film, const char* genre)
+{
+    return match_token(film_getGenre(film), sizeof(film->genre), genre);
+}
+
+static inline int film_hasRating(const Film *film, const char* rating)
+{
+    return match_exact(film_getRating(film), sizeof(film->rating), rating);
+}
+
+static inline int film_isRRated(const Film *film)
+{
+    return film_hasRating(film, "R");
+}
+
 /*******************************************************************************
 
 Procedure   : film_new
@@ -137,6 +276,21 @@ Film *film_new(char* title, int year, char* rating, char* genre,
 
 /*******************************************************************************
 
+Procedure   : film_newLazy
+
+Parameters  : FilmText* text - text of a lazily loaded file
+              const char* record - start of the film's record in text
+ 
+Returns     : Film* - pointer to newly created film struct
+ 
+Description : Allocates a Film Struct with no field decoded yet, taking a share
+              of text, which is kept until the film is freed.
+
+ ******************************************************************************/
+Film *film_newLazy(FilmText* text, const char* record);
+
+/*******************************************************************************
+
 Procedure   : film_print
 
 Parameters  : film - a Film struct node that contains the all the information 
@@ -148,6 +302,57 @@ Description : Prints out a single Film Struct node, in a formatted fashion.
 
  ******************************************************************************/
 void film_print(Film* film);
+
+/*******************************************************************************
+
+Procedure   : film_printFound
+
+Parameters  : film - the film found, or NULL if there was none
+              index - the position that was looked for
+ 
+Returns     : void
+ 
+Description : Prints film as film_print does, or "No such film" when fewer
+              than index films were found.
+
+ ******************************************************************************/
+void film_printFound(Film* film, int index);
+
+/*******************************************************************************
+
+Procedure   : film_toLine
+
+Parameters  : const Film* film - a filled Film struct
+              char* buffer - destination for the formatted line
+              size_t size - number of bytes available in buffer
+ 
+Returns     : int - number of characters the full line needs (excluding the
+                    terminating null), as with snprintf
+ 
+Description : Formats a single Film Struct as one line in the same layout as
+              the films.txt file, including the trailing newline. Quotes
+              inside the text fields are doubled so the line reads back in.
+
+ ******************************************************************************/
+int film_toLine(const Film* film, char* buffer, size_t size);
+
+/*******************************************************************************
+
+Procedure   : film_write
+
+Parameters  : FILE* output - a file open for writing
+              const Film* film - a filled Film struct
+ 
+Returns     : void
+ 
+Description : Writes a single Film Struct to output as one line in the same
+              layout as the films.txt file. Unlike film_toLine the review
+              rating is written with all its digits (%.9g), so reading the
+              line back gives the same float.
+
+ ******************************************************************************/
+void film_write(FILE* output, const Film* film);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,387 @@
+/*
+ * File         : filmindex.c
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Source file that implements the (title, year) index described
+ *                in filmindex.h.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - filmindex_bytes.
+ *                19/10/2026 v1.20 - Memory allocated through mvdb.h.
+ *                19/10/2026 v1.30 - filmindex_rekey.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "filmindex.h"
+#include "mvdb.h"
+
+/*
+ * Interned titles are packed one after another into chunks, so loading tens
+ * of millions of films costs a handful of allocations rather than one each.
+ */
+#define FILMINDEX_CHUNK (1 << 20)
+
+typedef struct _FilmIndexChunk
+{
+    struct _FilmIndexChunk* next;
+    size_t used;
+    size_t size;
+    char text[];
+}FilmIndexChunk;
+
+/*
+ * FNV-1a over the title, then a final mix so the low bits used for the slot
+ * number depend on every byte.
+ */
+static unsigned int filmindex_mix(unsigned int hash)
+{
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+
+    return hash;
+}
+
+static unsigned int filmindex_titleHash(const char* title)
+{
+    unsigned int hash = 2166136261u;
+
+    for (; *title != '\0'; title++)
+    {
+        hash = (hash ^ (unsigned char)*title) * 16777619u;
+    }
+
+    return filmindex_mix(hash);
+}
+
+static unsigned int filmindex_keyHash(unsigned int titleHash, int year)
+{
+    return filmindex_mix(titleHash ^ ((unsigned int)year * 0x9e3779b1u));
+}
+
+static size_t filmindex_capacity(size_t expected)
+{
+    size_t capacity = 16;
+
+    while (capacity < expected * 2)
+    {
+        capacity *= 2;
+    }
+
+    return capacity;
+}
+
+FilmIndex* filmindex_new(size_t expected)
+{
+    FilmIndex* index = (FilmIndex*)mvdb_alloc(sizeof(FilmIndex));
+    size_t capacity = filmindex_capacity(expected);
+
+    index->slots = (FilmIndexSlot*)mvdb_alloc(
+            capacity * sizeof(FilmIndexSlot));
+    index->mask = capacity - 1;
+    index->titles = (FilmIndexTitle*)mvdb_alloc(
+            capacity * sizeof(FilmIndexTitle));
+    index->titleMask = capacity - 1;
+
+    return index;
+}
+
+/*
+ * Returns the slot holding the interned copy of title, or the empty slot
+ * where it would go.
+ */
+static FilmIndexTitle* filmindex_titleSlot(const FilmIndex* index,
+        const char* title, unsigned int hash)
+{
+    size_t i = hash & index->titleMask;
+
+    for (;;)
+    {
+        FilmIndexTitle* slot = &index->titles[i];
+
+        if (slot->title == NULL || (slot->hash == hash
+                && strcmp(slot->title, title) == 0))
+        {
+            return slot;
+        }
+
+        i = (i + 1) & index->titleMask;
+    }
+}
+
+static const char* filmindex_copy(FilmIndex* index, const char* title)
+{
+    size_t length = strlen(title) + 1;
+    FilmIndexChunk* chunk = index->chunks;
+
+    if (chunk == NULL || chunk->size - chunk->used < length)
+    {
+        size_t size = length > FILMINDEX_CHUNK ? length : FILMINDEX_CHUNK;
+
+        chunk = (FilmIndexChunk*)mvdb_alloc(sizeof(FilmIndexChunk)
+                + size);
+        chunk->size = size;
+        chunk->next = index->chunks;
+        index->chunks = chunk;
+    }
+
+    char* copy = chunk->text + chunk->used;
+
+    memcpy(copy, title, length);
+    chunk->used += length;
+
+    return copy;
+}
+
+static void filmindex_growTitles(FilmIndex* index)
+{
+    FilmIndexTitle* old = index->titles;
+    size_t capacity = (index->titleMask + 1) * 2;
+
+    index->titles = (FilmIndexTitle*)mvdb_alloc(
+            capacity * sizeof(FilmIndexTitle));
+    index->titleMask = capacity - 1;
+
+    for (size_t i = 0; i < capacity / 2; i++)
+    {
+        if (old[i].title != NULL)
+        {
+            size_t j = old[i].hash & index->titleMask;
+
+            while (index->titles[j].title != NULL)
+            {
+                j = (j + 1) & index->titleMask;
+            }
+
+            index->titles[j] = old[i];
+        }
+    }
+
+    free(old);
+}
+
+static const char* filmindex_intern(FilmIndex* index, const char* title,
+        unsigned int hash)
+{
+    FilmIndexTitle* slot = filmindex_titleSlot(index, title, hash);
+
+    if (slot->title == NULL)
+    {
+        slot->hash = hash;
+        slot->title = filmindex_copy(index, title);
+        index->titleCount++;
+
+        if (index->titleCount * 2 > index->titleMask + 1)
+        {
+            filmindex_growTitles(index);
+        }
+
+        return filmindex_titleSlot(index, title, hash)->title;
+    }
+
+    return slot->title;
+}
+
+/*
+ * Returns the slot holding the key, or the empty slot where it would go.
+ * title must already be interned, so it is compared by pointer.
+ */
+static FilmIndexSlot* filmindex_slot(const FilmIndex* index,
+        const char* title, int year, unsigned int hash)
+{
+    size_t i = hash & index->mask;
+
+    for (;;)
+    {
+        FilmIndexSlot* slot = &index->slots[i];
+
+        if (slot->film == NULL || (slot->hash == hash && slot->title == title
+                && slot->year == year))
+        {
+            return slot;
+        }
+
+        i = (i + 1) & index->mask;
+    }
+}
+
+static void filmindex_grow(FilmIndex* index)
+{
+    FilmIndexSlot* old = index->slots;
+    size_t capacity = (index->mask + 1) * 2;
+
+    index->slots = (FilmIndexSlot*)mvdb_alloc(
+            capacity * sizeof(FilmIndexSlot));
+    index->mask = capacity - 1;
+
+    for (size_t i = 0; i < capacity / 2; i++)
+    {
+        if (old[i].film != NULL)
+        {
+            size_t j = old[i].hash & index->mask;
+
+            while (index->slots[j].film != NULL)
+            {
+                j = (j + 1) & index->mask;
+            }
+
+            index->slots[j] = old[i];
+        }
+    }
+
+    free(old);
+}
+
+Film* filmindex_find(const FilmIndex* index, const char* title, int year)
+{
+    unsigned int titleHash = filmindex_titleHash(title);
+    const char* interned = filmindex_titleSlot(index, title, titleHash)->title;
+
+    if (interned == NULL)
+    {
+        return NULL;
+    }
+
+    return filmindex_slot(index, interned, year,
+            filmindex_keyHash(titleHash, year))->film;
+}
+
+Film* filmindex_put(FilmIndex* index, Film* film)
+{
+    unsigned int titleHash = filmindex_titleHash(film_getTitle(film));
+    const char* title = filmindex_intern(index, film_getTitle(film), titleHash);
+    int year = film_getYear(film);
+    unsigned int hash = filmindex_keyHash(titleHash, year);
+    FilmIndexSlot* slot = filmindex_slot(index, title, year, hash);
+
+    if (slot->film != NULL)
+    {
+        return slot->film;
+    }
+
+    slot->hash = hash;
+    slot->year = year;
+    slot->title = title;
+    slot->film = film;
+    index->count++;
+
+    if (index->count * 2 > index->mask + 1)
+    {
+        filmindex_grow(index);
+    }
+
+    return NULL;
+}
+
+/*
+ * Empties slot without leaving a tombstone.
+ */
+static void filmindex_unlink(FilmIndex* index, FilmIndexSlot* slot)
+{
+    /* Pull back any later entry whose home slot is at or before the hole */
+    size_t hole = slot - index->slots;
+
+    for (size_t i = (hole + 1) & index->mask; index->slots[i].film != NULL;
+            i = (i + 1) & index->mask)
+    {
+        size_t home = index->slots[i].hash & index->mask;
+
+        if (((i - home) & index->mask) >= ((i - hole) & index->mask))
+        {
+            index->slots[hole] = index->slots[i];
+            hole = i;
+        }
+    }
+
+    index->slots[hole].film = NULL;
+    index->count--;
+}
+
+void filmindex_remove(FilmIndex* index, const Film* film)
+{
+    unsigned int titleHash = filmindex_titleHash(film_getTitle(film));
+    const char* title = filmindex_titleSlot(index, film_getTitle(film),
+            titleHash)->title;
+
+    if (title == NULL)
+    {
+        return;
+    }
+
+    int year = film_getYear(film);
+    FilmIndexSlot* slot = filmindex_slot(index, title, year,
+            filmindex_keyHash(titleHash, year));
+
+    if (slot->film == film)
+    {
+        filmindex_unlink(index, slot);
+    }
+}
+
+Film* filmindex_rekey(FilmIndex* index, Film* film)
+{
+    if (filmindex_find(index, film_getTitle(film), film_getYear(film)) == film)
+    {
+        return NULL;
+    }
+
+    for (size_t i = 0; i <= index->mask; i++)
+    {
+        if (index->slots[i].film == film)
+        {
+            filmindex_unlink(index, &index->slots[i]);
+
+            return filmindex_put(index, film);
+        }
+    }
+
+    return NULL;
+}
+
+void filmindex_free(FilmIndex* index)
+{
+    if (index == NULL)
+    {
+        return;
+    }
+
+    while (index->chunks != NULL)
+    {
+        FilmIndexChunk* chunk = index->chunks;
+
+        index->chunks = chunk->next;
+        free(chunk);
+    }
+
+    free(index->slots);
+    free(index->titles);
+    free(index);
+}
+
+size_t filmindex_bytes(const FilmIndex* index)
+{
+    if (index == NULL)
+    {
+        return 0;
+    }
+
+    size_t bytes = sizeof(FilmIndex)
+            + (index->mask + 1) * sizeof(FilmIndexSlot)
+            + (index->titleMask + 1) * sizeof(FilmIndexTitle);
+
+    for (const FilmIndexChunk* chunk = index->chunks; chunk != NULL;
+            chunk = chunk->next)
+    {
+        bytes += sizeof(FilmIndexChunk) + chunk->size;
+    }
+
+    return bytes;
+}
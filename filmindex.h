@@ -0,0 +1,173 @@
+/*
+ * File         : filmindex.h
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Header file that defines a primary key index over films.
+ *                A film is identified by its title and year. The index is an
+ *                open addressing hash table (linear probing) from that key to
+ *                the Film, so a film can be found, replaced or merged in
+ *                constant expected time rather than by walking the list.
+ *                Titles are interned: each distinct title is stored once in
+ *                the index, so keys compare by pointer and remakes sharing a
+ *                title share its storage.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - filmindex_bytes.
+ *                19/10/2026 v1.20 - filmindex_rekey.
+ */
+
+#ifndef FILMINDEX_H
+#define FILMINDEX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+#include "film.h"
+
+typedef struct _FilmIndexSlot
+{
+    unsigned int hash;
+    int year;
+    const char* title;
+    Film* film;
+}FilmIndexSlot;
+
+typedef struct _FilmIndexTitle
+{
+    unsigned int hash;
+    const char* title;
+}FilmIndexTitle;
+
+typedef struct _FilmIndex
+{
+    FilmIndexSlot* slots;
+    size_t mask;
+    size_t count;
+    FilmIndexTitle* titles;
+    size_t titleMask;
+    size_t titleCount;
+    struct _FilmIndexChunk* chunks;
+}FilmIndex;
+
+/*******************************************************************************
+
+Procedure   : filmindex_new
+
+Parameters  : size_t expected - number of films the index should hold before
+                                it first has to grow, or 0 if not known
+
+Returns     : FilmIndex* - an empty index
+
+Description : Creates an empty index. The tables grow by doubling whenever
+              they become half full, so expected only saves the rehashing.
+
+ ******************************************************************************/
+FilmIndex* filmindex_new(size_t expected);
+
+/*******************************************************************************
+
+Procedure   : filmindex_find
+
+Parameters  : const FilmIndex* index - index to search
+              const char* title - title of the film
+              int year - year of the film
+
+Returns     : Film* - the film with that title and year, or NULL if none
+
+Description : Looks up a film by its key.
+
+ ******************************************************************************/
+Film* filmindex_find(const FilmIndex* index, const char* title, int year);
+
+/*******************************************************************************
+
+Procedure   : filmindex_put
+
+Parameters  : FilmIndex* index - index to add to
+              Film* film - film to add
+
+Returns     : Film* - the film already held under the same key, or NULL if
+                      film was added
+
+Description : Adds film under its title and year unless a film with the same
+              key is already held, in which case the index is left as it was
+              and the held film is returned.
+
+ ******************************************************************************/
+Film* filmindex_put(FilmIndex* index, Film* film);
+
+/*******************************************************************************
+
+Procedure   : filmindex_remove
+
+Parameters  : FilmIndex* index - index to remove from
+              const Film* film - film to remove
+
+Returns     : void
+
+Description : Removes film if it is the one held under its key. The slots
+              after it are shifted back, so no tombstones are left behind.
+              The interned title is kept for the life of the index.
+
+ ******************************************************************************/
+void filmindex_remove(FilmIndex* index, const Film* film);
+
+/*******************************************************************************
+
+Procedure   : filmindex_rekey
+
+Parameters  : FilmIndex* index - index that may hold film
+              Film* film - film whose title or year has changed
+
+Returns     : Film* - the film already held under the new key, or NULL if
+                      film was moved to it or is not held
+
+Description : Moves film from the key it was added under to its current
+              title and year. The old key is no longer known, so the table
+              is walked to find film; this suits the occasional edit rather
+              than bulk changes. If another film already has the new key,
+              film is dropped from the index as filmindex_put would have
+              refused it.
+
+ ******************************************************************************/
+Film* filmindex_rekey(FilmIndex* index, Film* film);
+
+/*******************************************************************************
+
+Procedure   : filmindex_free
+
+Parameters  : FilmIndex* index - index to free
+
+Returns     : void
+
+Description : Frees the index and its interned titles. The films are not
+              freed.
+
+ ******************************************************************************/
+void filmindex_free(FilmIndex* index);
+
+/*******************************************************************************
+
+Procedure   : filmindex_bytes
+
+Parameters  : const FilmIndex* index - index from filmindex_new, or NULL
+
+Returns     : size_t - bytes allocated for the index and its interned titles,
+                       or 0 for NULL
+
+Description : Adds up the tables and title chunks without walking the slots.
+
+ ******************************************************************************/
+size_t filmindex_bytes(const FilmIndex* index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FILMINDEX_H */
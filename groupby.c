@@ -0,0 +1,398 @@
+/*
+ * File         : groupby.c
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Source file that implements the group-by engine described in
+ *                groupby.h.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - Memory allocated through mvdb.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "groupby.h"
+#include "mvdb.h"
+
+typedef struct _GroupWorker
+{
+    pthread_t thread;
+    const GroupResult* result;
+    Film** films;
+    int begin;
+    int end;
+    GroupStats* partial;
+}GroupWorker;
+
+static void* groupby_grow(void* memory, int* size, size_t element)
+{
+    *size = *size == 0 ? 16 : *size * 2;
+
+    return mvdb_grow(memory, *size * element);
+}
+
+GroupKey groupby_key(const char* name)
+{
+    if (name != NULL && strcmp(name, "rating") == 0)
+    {
+        return GROUP_RATING;
+    }
+    if (name != NULL && strcmp(name, "genre") == 0)
+    {
+        return GROUP_GENRE;
+    }
+    if (name != NULL && strcmp(name, "decade") == 0)
+    {
+        return GROUP_DECADE;
+    }
+
+    return GROUP_NONE;
+}
+
+/*
+ * Returns the dense id of a key value, giving it the next id if it has not
+ * been seen before. The key spaces here are small (a dozen certificates, a
+ * couple of dozen genres), so a linear scan beats hashing.
+ */
+static int column_intern(GroupColumn* column, const char* text, size_t length)
+{
+    for (int id = 0; id < column->distinct; id++)
+    {
+        if (strncmp(column->names[id], text, length) == 0
+                && column->names[id][length] == '\0')
+        {
+            return id;
+        }
+    }
+
+    if (column->distinct == column->size)
+    {
+        column->names = (char**)groupby_grow(column->names, &column->size,
+                sizeof(char*));
+    }
+
+    column->names[column->distinct] = strndup(text, length);
+
+    return column->distinct++;
+}
+
+/*
+ * Gives every film the ids of its key values. Genres can have several values
+ * per film, so ids are stored compressed: film i owns
+ * ids[offsets[i]] .. ids[offsets[i + 1] - 1].
+ */
+static void column_build(GroupColumn* column, GroupKey key, Film** films,
+        int count)
+{
+    int idsSize = count > 0 ? count : 1;
+    int used = 0;
+
+    memset(column, 0, sizeof(GroupColumn));
+    column->key = key;
+    column->offsets = (int*)mvdb_alloc((count + 1) * sizeof(int));
+    column->ids = (int*)mvdb_alloc(idsSize * sizeof(int));
+
+    if (key == GROUP_DECADE)
+    {
+        int first = 0;
+        int last = 0;
+
+        for (int i = 0; i < count; i++)
+        {
+            int decade = film_getYear(films[i]) / 10;
+
+            if (i == 0 || decade < first)
+            {
+                first = decade;
+            }
+            if (i == 0 || decade > last)
+            {
+                last = decade;
+            }
+        }
+
+        column->firstDecade = first * 10;
+        column->distinct = count > 0 ? last - first + 1 : 0;
+        column->size = column->distinct;
+        column->names = (char**)mvdb_alloc(column->size * sizeof(char*));
+
+        for (int d = 0; d < column->distinct; d++)
+        {
+            column->names[d] = (char*)mvdb_alloc(16);
+            snprintf(column->names[d], 16, "%ds", (first + d) * 10);
+        }
+    }
+    else if (key == GROUP_NONE)
+    {
+        column_intern(column, "all", 3);
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        column->offsets[i] = used;
+
+        if (key == GROUP_GENRE)
+        {
+            const char* genre = film_getGenre(films[i]);
+
+            while (*genre != '\0')
+            {
+                size_t length = strcspn(genre, "/");
+
+                if (used == idsSize)
+                {
+                    column->ids = (int*)groupby_grow(column->ids, &idsSize,
+                            sizeof(int));
+                }
+
+                column->ids[used++] = column_intern(column, genre, length);
+                genre += length + (genre[length] == '/');
+            }
+        }
+        else if (key == GROUP_RATING)
+        {
+            const char* rating = film_getRating(films[i]);
+            column->ids[used++] = column_intern(column, rating, strlen(rating));
+        }
+        else if (key == GROUP_DECADE)
+        {
+            column->ids[used++] = film_getYear(films[i]) / 10
+                    - column->firstDecade / 10;
+        }
+        else
+        {
+            column->ids[used++] = 0;
+        }
+    }
+
+    column->offsets[count] = used;
+}
+
+static void column_free(GroupColumn* column)
+{
+    for (int id = 0; id < column->distinct; id++)
+    {
+        free(column->names[id]);
+    }
+
+    free(column->names);
+    free(column->offsets);
+    free(column->ids);
+}
+
+static void stats_clear(GroupStats* groups, int count)
+{
+    memset(groups, 0, count * sizeof(GroupStats));
+}
+
+static void stats_add(GroupStats* stats, const Film* film)
+{
+    int length = film_getLength(film);
+    float review = film_getReviewRating(film);
+
+    if (stats->count == 0 || length < stats->lengthMin)
+    {
+        stats->lengthMin = length;
+    }
+    if (stats->count == 0 || length > stats->lengthMax)
+    {
+        stats->lengthMax = length;
+    }
+    if (stats->count == 0 || review < stats->reviewMin)
+    {
+        stats->reviewMin = review;
+    }
+    if (stats->count == 0 || review > stats->reviewMax)
+    {
+        stats->reviewMax = review;
+    }
+
+    stats->count++;
+    stats->lengthSum += length;
+    stats->reviewSum += review;
+}
+
+static void stats_merge(GroupStats* into, const GroupStats* from)
+{
+    if (from->count == 0)
+    {
+        return;
+    }
+    if (into->count == 0)
+    {
+        *into = *from;
+        return;
+    }
+
+    into->lengthMin = from->lengthMin < into->lengthMin
+            ? from->lengthMin : into->lengthMin;
+    into->lengthMax = from->lengthMax > into->lengthMax
+            ? from->lengthMax : into->lengthMax;
+    into->reviewMin = from->reviewMin < into->reviewMin
+            ? from->reviewMin : into->reviewMin;
+    into->reviewMax = from->reviewMax > into->reviewMax
+            ? from->reviewMax : into->reviewMax;
+    into->count += from->count;
+    into->lengthSum += from->lengthSum;
+    into->reviewSum += from->reviewSum;
+}
+
+static void* groupby_worker(void* argument)
+{
+    GroupWorker* worker = (GroupWorker*)argument;
+    const GroupColumn* outer = &worker->result->columns[0];
+    const GroupColumn* inner = &worker->result->columns[1];
+
+    for (int i = worker->begin; i < worker->end; i++)
+    {
+        for (int a = outer->offsets[i]; a < outer->offsets[i + 1]; a++)
+        {
+            GroupStats* row = worker->partial + outer->ids[a] * inner->distinct;
+
+            for (int b = inner->offsets[i]; b < inner->offsets[i + 1]; b++)
+            {
+                stats_add(&row[inner->ids[b]], worker->films[i]);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+GroupResult* groupby_run(List* list, GroupKey primary, GroupKey secondary,
+        int threads)
+{
+    int count = list_length(list);
+    Film** films = (Film**)mvdb_alloc((count > 0 ? count : 1)
+            * sizeof(Film*));
+    int f = 0;
+
+    for (Iterator i = list_begin(list); i != list_end(list);
+            i = iterator_next(i))
+    {
+        films[f++] = iterator_value(i);
+    }
+
+    GroupResult* result = (GroupResult*)mvdb_alloc(sizeof(GroupResult));
+
+    column_build(&result->columns[0], primary, films, count);
+    column_build(&result->columns[1], secondary, films, count);
+
+    int groups = result->columns[0].distinct * result->columns[1].distinct;
+
+    if (threads < 1 || count < GROUPBY_PARALLEL_MIN)
+    {
+        threads = 1;
+    }
+
+    result->threads = threads;
+    result->groups = (GroupStats*)mvdb_alloc(
+            (groups > 0 ? groups : 1) * sizeof(GroupStats));
+    stats_clear(result->groups, groups);
+
+    GroupWorker* workers = (GroupWorker*)mvdb_alloc(
+            threads * sizeof(GroupWorker));
+
+    for (int t = 0; t < threads; t++)
+    {
+        workers[t].result = result;
+        workers[t].films = films;
+        workers[t].begin = (int)((long)count * t / threads);
+        workers[t].end = (int)((long)count * (t + 1) / threads);
+
+        if (threads == 1)
+        {
+            workers[t].partial = result->groups;
+            groupby_worker(&workers[t]);
+        }
+        else
+        {
+            workers[t].partial = (GroupStats*)mvdb_alloc(
+                    (groups > 0 ? groups : 1) * sizeof(GroupStats));
+            stats_clear(workers[t].partial, groups);
+            pthread_create(&workers[t].thread, NULL, groupby_worker,
+                    &workers[t]);
+        }
+    }
+
+    if (threads > 1)
+    {
+        for (int t = 0; t < threads; t++)
+        {
+            pthread_join(workers[t].thread, NULL);
+
+            for (int g = 0; g < groups; g++)
+            {
+                stats_merge(&result->groups[g], &workers[t].partial[g]);
+            }
+
+            free(workers[t].partial);
+        }
+    }
+
+    free(workers);
+    free(films);
+
+    return result;
+}
+
+void groupby_print(const GroupResult* result)
+{
+    const GroupColumn* outer = &result->columns[0];
+    const GroupColumn* inner = &result->columns[1];
+
+    printf("\n");
+    printf("*********************************************************\n");
+    printf("%-28s %7s  %s\n", "Group", "Films",
+            "Run time sum/min/max/mean   Review sum/min/max/mean");
+
+    for (int a = 0; a < outer->distinct; a++)
+    {
+        for (int b = 0; b < inner->distinct; b++)
+        {
+            const GroupStats* stats = &result->groups[a * inner->distinct + b];
+            char name[64];
+
+            if (stats->count == 0)
+            {
+                continue;
+            }
+
+            const char* outerName = outer->names[a][0] != '\0'
+                    ? outer->names[a] : "(none)";
+            const char* innerName = inner->names[b][0] != '\0'
+                    ? inner->names[b] : "(none)";
+
+            if (inner->key == GROUP_NONE)
+            {
+                snprintf(name, sizeof(name), "%s", outerName);
+            }
+            else
+            {
+                snprintf(name, sizeof(name), "%s / %s", outerName, innerName);
+            }
+
+            printf("%-28s %7ld  %8.0f %3d %3d %6.1f   %8.1f %3.1f %3.1f %4.2f\n",
+                    name, stats->count, stats->lengthSum, stats->lengthMin,
+                    stats->lengthMax, stats->lengthSum / stats->count,
+                    stats->reviewSum, stats->reviewMin, stats->reviewMax,
+                    stats->reviewSum / stats->count);
+        }
+    }
+
+    printf("*********************************************************\n");
+}
+
+void groupby_free(GroupResult* result)
+{
+    column_free(&result->columns[0]);
+    column_free(&result->columns[1]);
+    free(result->groups);
+    free(result);
+}
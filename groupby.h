@@ -0,0 +1,138 @@
+/*
+ * File         : groupby.h
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Header file that defines a group-by engine over the movie
+ *                database. Films are grouped by certificate, by each of the
+ *                "/" separated tokens of their genre or by decade, on one key
+ *                or a pair of keys, and count, sum, min, max and mean are
+ *                worked out for the run time and review rating of each group.
+ *
+ * History      : 19/10/2026 v1.00
+ */
+
+#ifndef GROUPBY_H
+#define GROUPBY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "moviedatabase.h"
+
+/*
+ * Collections smaller than this are aggregated on a single thread, as
+ * starting threads would cost more than it saves.
+ */
+#define GROUPBY_PARALLEL_MIN 65536
+
+typedef enum
+{
+    GROUP_NONE,
+    GROUP_RATING,
+    GROUP_GENRE,
+    GROUP_DECADE
+}GroupKey;
+
+/*
+ * Distinct values of one key. Each value is given a dense id, its position
+ * in names, which is used to index the group arrays directly.
+ */
+typedef struct _GroupColumn
+{
+    GroupKey key;
+    char** names;
+    int distinct;
+    int size;
+    int firstDecade;
+    int* offsets;
+    int* ids;
+}GroupColumn;
+
+typedef struct _GroupStats
+{
+    long count;
+    double lengthSum;
+    int lengthMin;
+    int lengthMax;
+    double reviewSum;
+    float reviewMin;
+    float reviewMax;
+}GroupStats;
+
+typedef struct _GroupResult
+{
+    GroupColumn columns[2];
+    GroupStats* groups;
+    int threads;
+}GroupResult;
+
+/*******************************************************************************
+
+Procedure   : groupby_key
+
+Parameters  : const char* name - "rating", "genre" or "decade"
+
+Returns     : GroupKey - the matching key, or GROUP_NONE if name is not known
+
+Description : Looks up a group-by key from its name on the command line.
+
+ ******************************************************************************/
+GroupKey groupby_key(const char* name);
+
+/*******************************************************************************
+
+Procedure   : groupby_run
+
+Parameters  : List* list - a filled linked list of Film structs
+              GroupKey primary - key to group by
+              GroupKey secondary - second key to group by within the first,
+                                   or GROUP_NONE
+              int threads - most threads to aggregate with
+
+Returns     : GroupResult* - the aggregates of every group
+
+Description : Gives every distinct key value a dense id in one pass over the
+              list, then aggregates straight into an array indexed by those
+              ids. Large collections are split between threads, each filling
+              its own partial array, and the partials are merged at the end.
+
+ ******************************************************************************/
+GroupResult* groupby_run(List* list, GroupKey primary, GroupKey secondary,
+        int threads);
+
+/*******************************************************************************
+
+Procedure   : groupby_print
+
+Parameters  : const GroupResult* result - aggregates from groupby_run
+
+Returns     : void
+
+Description : Prints one row per non-empty group with its count and the sum,
+              min, max and mean of run time and review rating.
+
+ ******************************************************************************/
+void groupby_print(const GroupResult* result);
+
+/*******************************************************************************
+
+Procedure   : groupby_free
+
+Parameters  : GroupResult* result - aggregates from groupby_run
+
+Returns     : void
+
+Description : Frees the result and everything it holds.
+
+ ******************************************************************************/
+void groupby_free(GroupResult* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GROUPBY_H */
@@ -0,0 +1,106 @@
+/*
+ * File         : journal.c
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Source file that implements the change journal described in
+ *                journal.h.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - Memory allocated through mvdb.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "journal.h"
+#include "mvdb.h"
+
+Journal* journal_new()
+{
+    Journal* journal = (Journal*)mvdb_alloc(sizeof(Journal));
+
+    return journal;
+}
+
+void journal_listen(Journal* journal, JournalListener listener, void* context)
+{
+    if (journal->count == journal->size)
+    {
+        journal->size = journal->size == 0 ? 4 : journal->size * 2;
+        journal->subscribers = (JournalSubscriber*)mvdb_grow(
+                journal->subscribers,
+                journal->size * sizeof(JournalSubscriber));
+    }
+
+    journal->subscribers[journal->count].listener = listener;
+    journal->subscribers[journal->count].context = context;
+    journal->count++;
+}
+
+void journal_unlisten(Journal* journal, JournalListener listener,
+        void* context)
+{
+    for (int i = 0; i < journal->count; i++)
+    {
+        if (journal->subscribers[i].listener == listener
+                && journal->subscribers[i].context == context)
+        {
+            memmove(&journal->subscribers[i], &journal->subscribers[i + 1],
+                    (journal->count - i - 1) * sizeof(JournalSubscriber));
+            journal->count--;
+
+            return;
+        }
+    }
+}
+
+long journal_append(Journal* journal, JournalOp op, Film* film,
+        FilmField field)
+{
+    JournalEntry* entry = &journal->ring[journal->sequence
+            & (JOURNAL_RING - 1)];
+
+    entry->sequence = journal->sequence++;
+    entry->op = op;
+    entry->field = field;
+    entry->film = film;
+
+    for (int i = 0; i < journal->count; i++)
+    {
+        journal->subscribers[i].listener(journal->subscribers[i].context,
+                entry);
+    }
+
+    return entry->sequence;
+}
+
+void journal_update(Journal* journal, Film* film, FilmField field)
+{
+    journal_append(journal, JOURNAL_UPDATE, film, field);
+}
+
+const JournalEntry* journal_entry(const Journal* journal, long sequence)
+{
+    if (sequence < 0 || sequence >= journal->sequence
+            || sequence < journal->sequence - JOURNAL_RING)
+    {
+        return NULL;
+    }
+
+    return &journal->ring[sequence & (JOURNAL_RING - 1)];
+}
+
+void journal_free(Journal* journal)
+{
+    if (journal == NULL)
+    {
+        return;
+    }
+
+    free(journal->subscribers);
+    free(journal);
+}
@@ -0,0 +1,170 @@
+/*
+ * File         : journal.h
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Header file that defines the change journal of a list. Every
+ *                film added to or removed from the list, and every change made
+ *                through the film_set methods, is numbered and passed on to
+ *                the listeners registered with the journal as it happens. 
+ *                Results derived from the list (see view.h) listen to the 
+ *                journal so they can be brought up to date one change at a 
+ *                time instead of being worked out again from the whole list.
+ *                The most recent JOURNAL_RING changes are also kept so they 
+ *                can be read back by sequence number.
+ *
+ * History      : 19/10/2026 v1.00
+ */
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "film.h"
+
+/*
+ * Number of recent changes kept for journal_entry. Must be a power of two.
+ */
+#define JOURNAL_RING 4096
+
+typedef enum _JournalOp
+{
+    JOURNAL_INSERT,
+    JOURNAL_DELETE,
+    JOURNAL_UPDATE,
+    JOURNAL_CLEAR
+}JournalOp;
+
+/*
+ * One change. film is NULL for JOURNAL_CLEAR and field is only meaningful for
+ * JOURNAL_UPDATE. A JOURNAL_DELETE is recorded before the film is freed, but
+ * the film must not be used after the listeners return.
+ */
+typedef struct _JournalEntry
+{
+    long sequence;
+    JournalOp op;
+    FilmField field;
+    Film* film;
+}JournalEntry;
+
+typedef void (*JournalListener)(void* context, const JournalEntry* entry);
+
+typedef struct _JournalSubscriber
+{
+    JournalListener listener;
+    void* context;
+}JournalSubscriber;
+
+typedef struct _Journal
+{
+    long sequence;
+    JournalEntry ring[JOURNAL_RING];
+    JournalSubscriber* subscribers;
+    int count;
+    int size;
+}Journal;
+
+/*******************************************************************************
+
+Procedure   : journal_new
+
+Parameters  : No parameters
+
+Returns     : Journal* - an empty journal with no listeners
+
+Description : Creates a journal. Lists create their own with list_journal().
+
+ ******************************************************************************/
+Journal* journal_new();
+
+/*******************************************************************************
+
+Procedure   : journal_listen
+
+Parameters  : Journal* journal - journal to listen to
+              JournalListener listener - called with every later change
+              void* context - passed back to listener
+
+Returns     : void
+
+Description : Registers a listener. Listeners are called in the order they
+              were registered, after the change has been made.
+
+ ******************************************************************************/
+void journal_listen(Journal* journal, JournalListener listener, void* context);
+
+/*******************************************************************************
+
+Procedure   : journal_unlisten
+
+Parameters  : Journal* journal - journal being listened to
+              JournalListener listener - listener given to journal_listen
+              void* context - context given to journal_listen
+
+Returns     : void
+
+Description : Removes a listener registered by journal_listen.
+
+ ******************************************************************************/
+void journal_unlisten(Journal* journal, JournalListener listener,
+        void* context);
+
+/*******************************************************************************
+
+Procedure   : journal_append
+
+Parameters  : Journal* journal - journal to record the change in
+              JournalOp op - kind of change
+              Film* film - film that changed, or NULL for JOURNAL_CLEAR
+              FilmField field - field that changed, for JOURNAL_UPDATE
+
+Returns     : long - sequence number given to the change
+
+Description : Numbers the change, keeps it in the ring and passes it to every
+              listener. Called by the list functions and the film_set 
+              methods rather than directly.
+
+ ******************************************************************************/
+long journal_append(Journal* journal, JournalOp op, Film* film,
+        FilmField field);
+
+/*******************************************************************************
+
+Procedure   : journal_entry
+
+Parameters  : const Journal* journal - journal to read
+              long sequence - number of the change wanted
+
+Returns     : const JournalEntry* - the change, or NULL if it has not happened
+                                    yet or is older than the ring holds
+
+Description : Reads back a recent change by its sequence number.
+
+ ******************************************************************************/
+const JournalEntry* journal_entry(const Journal* journal, long sequence);
+
+/*******************************************************************************
+
+Procedure   : journal_free
+
+Parameters  : Journal* journal - journal to free
+
+Returns     : void
+
+Description : Frees the journal. Anything still listening must not use it
+              again.
+
+ ******************************************************************************/
+void journal_free(Journal* journal);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JOURNAL_H */
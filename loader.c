@@ -0,0 +1,390 @@
+/*
+ * File         : loader.c
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Source file that implements the pipelined loader described
+ *                in loader.h.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - Memory and clock from mvdb.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "loader.h"
+#include "parser.h"
+#include "mvdb.h"
+
+/*
+ * Slots in each queue. Must be a power of two.
+ */
+#define LOADER_QUEUE 16
+
+typedef struct _LoaderQueue
+{
+    void* slots[LOADER_QUEUE];
+    atomic_size_t head;
+    atomic_size_t tail;
+}LoaderQueue;
+
+typedef struct _LoaderBuffer
+{
+    char* data;
+    size_t size;
+    size_t length;
+}LoaderBuffer;
+
+typedef struct _LoaderBatch
+{
+    int count;
+    Film* films[LOADER_BATCH];
+}LoaderBatch;
+
+typedef struct _Loader
+{
+    int fd;
+    off_t offset;
+    FILE* rejects;
+    LoaderQueue empty;
+    LoaderQueue filled;
+    LoaderQueue built;
+    LoaderStats stats;
+}Loader;
+
+/*
+ * Put on a queue after the last buffer or batch.
+ */
+static char loader_end;
+
+#define LOADER_END ((void*)&loader_end)
+
+/*
+ * Single producer, single consumer ring. Only the producer moves tail and
+ * only the consumer moves head, so each side needs one acquire load of the
+ * other's index and one release store of its own.
+ */
+static int queue_tryPush(LoaderQueue* queue, void* item)
+{
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+
+    if (tail - atomic_load_explicit(&queue->head, memory_order_acquire)
+            == LOADER_QUEUE)
+    {
+        return 0;
+    }
+
+    queue->slots[tail & (LOADER_QUEUE - 1)] = item;
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+
+    return 1;
+}
+
+static void* queue_tryPop(LoaderQueue* queue)
+{
+    size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+
+    if (head == atomic_load_explicit(&queue->tail, memory_order_acquire))
+    {
+        return NULL;
+    }
+
+    void* item = queue->slots[head & (LOADER_QUEUE - 1)];
+
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+
+    return item;
+}
+
+/*
+ * Spins briefly, then gives the core away, so a waiting stage does not
+ * starve the one it is waiting for when there are fewer cores than stages.
+ */
+static void loader_pause(int spins)
+{
+    if (spins > 16)
+    {
+        sched_yield();
+    }
+}
+
+static void queue_push(LoaderQueue* queue, void* item, double* waited)
+{
+    if (!queue_tryPush(queue, item))
+    {
+        double start = mvdb_now();
+
+        for (int spins = 0; !queue_tryPush(queue, item); spins++)
+        {
+            loader_pause(spins);
+        }
+
+        *waited += mvdb_now() - start;
+    }
+}
+
+static void* queue_pop(LoaderQueue* queue, double* waited)
+{
+    void* item = queue_tryPop(queue);
+
+    if (item == NULL)
+    {
+        double start = mvdb_now();
+
+        for (int spins = 0; (item = queue_tryPop(queue)) == NULL; spins++)
+        {
+            loader_pause(spins);
+        }
+
+        *waited += mvdb_now() - start;
+    }
+
+    return item;
+}
+
+static void loader_finish(LoaderStage* stage, double start)
+{
+    stage->busy = mvdb_now() - start - stage->starved - stage->blocked;
+}
+
+/*
+ * Read stage. Each buffer starts with whatever followed the last whole
+ * record of the buffer before, then is filled from the file and cut again.
+ */
+static void* loader_read(void* argument)
+{
+    Loader* loader = (Loader*)argument;
+    LoaderStage* stage = &loader->stats.stages[LOADER_READ];
+    double start = mvdb_now();
+    char* carry = NULL;
+    size_t carried = 0;
+    off_t offset = loader->offset;
+    int eof = 0;
+
+    while (!eof)
+    {
+        LoaderBuffer* buffer = (LoaderBuffer*)queue_pop(&loader->empty,
+                &stage->blocked);
+        size_t length = carried;
+        size_t complete = 0;
+
+        if (buffer->size < carried + LOADER_BLOCK)
+        {
+            buffer->size = carried + LOADER_BLOCK;
+            buffer->data = (char*)mvdb_grow(buffer->data, buffer->size);
+        }
+
+        if (carried > 0)
+        {
+            memcpy(buffer->data, carry, carried);
+        }
+
+        /* Keeps reading into the same buffer if no record ends in it */
+        while (complete == 0)
+        {
+            if (buffer->size - length < LOADER_BLOCK)
+            {
+                buffer->size *= 2;
+                buffer->data = (char*)mvdb_grow(buffer->data, buffer->size);
+            }
+
+            ssize_t got = pread(loader->fd, buffer->data + length,
+                    LOADER_BLOCK, offset);
+
+            if (got <= 0)
+            {
+                eof = 1;
+                complete = length;
+                break;
+            }
+
+            offset += got;
+            length += got;
+            loader->stats.bytes += got;
+            complete = parser_complete(buffer->data, length);
+        }
+
+        carried = length - complete;
+        carry = (char*)mvdb_grow(carry, carried > 0 ? carried : 1);
+        memcpy(carry, buffer->data + complete, carried);
+        buffer->length = complete;
+
+        queue_push(&loader->filled, buffer, &stage->blocked);
+    }
+
+    queue_push(&loader->filled, LOADER_END, &stage->blocked);
+    free(carry);
+    loader_finish(stage, start);
+
+    return NULL;
+}
+
+/*
+ * Parse stage. Buffers go back to the read stage as soon as their films
+ * have been copied out.
+ */
+static void* loader_parse(void* argument)
+{
+    Loader* loader = (Loader*)argument;
+    LoaderStage* stage = &loader->stats.stages[LOADER_PARSE];
+    double start = mvdb_now();
+    LoaderBatch* batch = (LoaderBatch*)mvdb_alloc(sizeof(LoaderBatch));
+    Parser parser;
+    FilmRecord record;
+
+    parser_init(&parser, NULL, loader->rejects);
+    batch->count = 0;
+
+    for (;;)
+    {
+        LoaderBuffer* buffer = (LoaderBuffer*)queue_pop(&loader->filled,
+                &stage->starved);
+
+        if (buffer == LOADER_END)
+        {
+            break;
+        }
+
+        parser_feed(&parser, buffer->data, buffer->length);
+
+        while (parser_next(&parser, &record))
+        {
+            batch->films[batch->count++] = film_fromRecord(&record);
+
+            if (batch->count == LOADER_BATCH)
+            {
+                queue_push(&loader->built, batch, &stage->blocked);
+                batch = (LoaderBatch*)mvdb_alloc(sizeof(LoaderBatch));
+                batch->count = 0;
+            }
+        }
+
+        queue_push(&loader->empty, buffer, &stage->blocked);
+    }
+
+    if (batch->count > 0)
+    {
+        queue_push(&loader->built, batch, &stage->blocked);
+    }
+    else
+    {
+        free(batch);
+    }
+
+    queue_push(&loader->built, LOADER_END, &stage->blocked);
+    loader->stats.rejected = parser.rejected;
+    parser_free(&parser);
+    loader_finish(stage, start);
+
+    return NULL;
+}
+
+List* loader_populate(FILE* input, FILE* rejects, LoaderStats* stats)
+{
+    Loader* loader = (Loader*)mvdb_alloc(sizeof(Loader));
+    LoaderBuffer buffers[LOADER_BUFFERS];
+    pthread_t reader;
+    pthread_t parser;
+    List* list = list_new();
+
+    loader->fd = fileno(input);
+    loader->offset = ftello(input);
+    loader->rejects = rejects;
+
+    if (loader->offset < 0)
+    {
+        loader->offset = 0;
+    }
+
+    for (int b = 0; b < LOADER_BUFFERS; b++)
+    {
+        buffers[b].size = 2 * LOADER_BLOCK;
+        buffers[b].data = (char*)mvdb_alloc(buffers[b].size);
+        queue_tryPush(&loader->empty, &buffers[b]);
+    }
+
+    double start = mvdb_now();
+    LoaderStage* stage = &loader->stats.stages[LOADER_BUILD];
+
+    pthread_create(&reader, NULL, loader_read, loader);
+    pthread_create(&parser, NULL, loader_parse, loader);
+
+    for (;;)
+    {
+        LoaderBatch* batch = (LoaderBatch*)queue_pop(&loader->built,
+                &stage->starved);
+
+        if (batch == LOADER_END)
+        {
+            break;
+        }
+
+        for (int f = 0; f < batch->count; f++)
+        {
+            list_add(list, batch->films[f]);
+        }
+
+        loader->stats.films += batch->count;
+        free(batch);
+    }
+
+    loader_finish(stage, start);
+    pthread_join(reader, NULL);
+    pthread_join(parser, NULL);
+    loader->stats.seconds = mvdb_now() - start;
+
+    printf("Films successfully read into MVDB: %li", loader->stats.films);
+
+    if (loader->stats.rejected > 0)
+    {
+        printf(" (%ld rows rejected)", loader->stats.rejected);
+    }
+
+    if (stats != NULL)
+    {
+        *stats = loader->stats;
+    }
+
+    for (int b = 0; b < LOADER_BUFFERS; b++)
+    {
+        free(buffers[b].data);
+    }
+
+    free(loader);
+
+    return list;
+}
+
+int loader_evict(FILE* input)
+{
+    return posix_fadvise(fileno(input), 0, 0, POSIX_FADV_DONTNEED);
+}
+
+void loader_print(const LoaderStats* stats)
+{
+    const char* names[LOADER_STAGES] = { "read", "parse", "build" };
+    double seconds = stats->seconds > 0 ? stats->seconds : 1e-9;
+
+    printf("\nLoaded %ld films, %.1f MB in %.1f ms (%.1f MB/s)\n",
+            stats->films, stats->bytes / 1e6, stats->seconds * 1e3,
+            stats->bytes / 1e6 / seconds);
+    printf("  %-6s %8s %8s %8s\n", "stage", "busy", "starved", "blocked");
+
+    for (int s = 0; s < LOADER_STAGES; s++)
+    {
+        printf("  %-6s %7.1f%% %7.1f%% %7.1f%%\n", names[s],
+                100 * stats->stages[s].busy / seconds,
+                100 * stats->stages[s].starved / seconds,
+                100 * stats->stages[s].blocked / seconds);
+    }
+}
@@ -0,0 +1,129 @@
+/*
+ * File         : loader.h
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Header file that defines a pipelined replacement for
+ *                list_populate. Loading is split into three stages that run
+ *                at the same time:
+ *                  read  - a thread reading LOADER_BLOCK bytes at a time with
+ *                          pread() into a ring of LOADER_BUFFERS buffers, cut
+ *                          at the last whole record
+ *                  parse - a thread turning each buffer into films with
+ *                          parser.h, in batches of LOADER_BATCH
+ *                  build - the calling thread, adding the films to the list
+ *                The stages are joined by bounded single producer, single
+ *                consumer queues that need no locks, and each stage times
+ *                how long it works and how long it waits, so the slowest
+ *                stage can be seen.
+ *
+ * History      : 19/10/2026 v1.00
+ */
+
+#ifndef LOADER_H
+#define LOADER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+
+#include "moviedatabase.h"
+
+/*
+ * Bytes asked for by each read, and the number of buffers in the ring.
+ */
+#define LOADER_BLOCK (1 << 20)
+#define LOADER_BUFFERS 4
+
+/*
+ * Films passed from the parse stage to the build stage at a time.
+ */
+#define LOADER_BATCH 1024
+
+typedef enum _LoaderStageId
+{
+    LOADER_READ,
+    LOADER_PARSE,
+    LOADER_BUILD,
+    LOADER_STAGES
+}LoaderStageId;
+
+/*
+ * Seconds a stage spent working, waiting for the stage before it (starved)
+ * and waiting for the stage after it (blocked).
+ */
+typedef struct _LoaderStage
+{
+    double busy;
+    double starved;
+    double blocked;
+}LoaderStage;
+
+typedef struct _LoaderStats
+{
+    double seconds;
+    long bytes;
+    long films;
+    long rejected;
+    LoaderStage stages[LOADER_STAGES];
+}LoaderStats;
+
+/*******************************************************************************
+
+Procedure   : loader_populate
+
+Parameters  : FILE* input - an open films.txt style file, read from its
+                            current position
+              FILE* rejects - file that rows which are not valid films are
+                              reported to, or NULL to drop them
+              LoaderStats* stats - filled in with the time taken by each
+                                   stage, or NULL
+
+Returns     : List* - a pointer to a linked list of film structs
+
+Description : Loads the same films, in the same order, with the same rejects
+              as list_populateRejects, with reading, parsing and building
+              the list overlapped.
+
+ ******************************************************************************/
+List* loader_populate(FILE* input, FILE* rejects, LoaderStats* stats);
+
+/*******************************************************************************
+
+Procedure   : loader_evict
+
+Parameters  : FILE* input - an open file
+
+Returns     : int - 0 if the request was made, or an error number
+
+Description : Asks the operating system to drop the file from its page cache,
+              so that the next load has to read it from disk (a cold cache).
+              Only clean pages can be dropped, so newly written files should
+              be flushed and synced first.
+
+ ******************************************************************************/
+int loader_evict(FILE* input);
+
+/*******************************************************************************
+
+Procedure   : loader_print
+
+Parameters  : const LoaderStats* stats - statistics from loader_populate
+
+Returns     : void
+
+Description : Prints the throughput and, for each stage, the share of the
+              load it spent working, starved and blocked.
+
+ ******************************************************************************/
+void loader_print(const LoaderStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOADER_H */
@@ -0,0 +1,193 @@
+/*
+ * File         : loadgen.c
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Source file that implements the load generator described in
+ *                loadgen.h.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - Memory and clock from mvdb.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "loadgen.h"
+#include "mvdb.h"
+
+static const char* loadgen_queries[] =
+{
+    "GENRE Drama\n",
+    "TOP review 10\n",
+    "RANGE year 1950 1959\n",
+    "TITLE Casablanca\n",
+    "GENRE Film-Noir\n",
+    "TOP length 3\n",
+    "RANGE length 150 240\n",
+    "TITLE The Third Man\n"
+};
+
+#define LOADGEN_QUERY_COUNT \
+        (int)(sizeof(loadgen_queries) / sizeof(loadgen_queries[0]))
+
+typedef struct _Worker
+{
+    pthread_t thread;
+    const char* path;
+    int requests;
+    int answered;
+    double* latencies;
+}Worker;
+
+static int loadgen_connect(const char* path)
+{
+    struct sockaddr_un address;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/*
+ * Reads one whole reply: the "OK <n>" header followed by n film lines.
+ */
+static int loadgen_readReply(FILE* in)
+{
+    char line[1024];
+    int count = 0;
+
+    if (fgets(line, sizeof(line), in) == NULL
+            || sscanf(line, "OK %d", &count) != 1)
+    {
+        return 0;
+    }
+
+    while (count > 0 && fgets(line, sizeof(line), in) != NULL)
+    {
+        if (strchr(line, '\n') != NULL)
+        {
+            count--;
+        }
+    }
+
+    return count == 0;
+}
+
+static void* loadgen_worker(void* argument)
+{
+    Worker* worker = (Worker*)argument;
+    int fd = loadgen_connect(worker->path);
+
+    if (fd < 0)
+    {
+        return NULL;
+    }
+
+    FILE* in = fdopen(fd, "r");
+
+    for (int i = 0; i < worker->requests; i++)
+    {
+        const char* query = loadgen_queries[i % LOADGEN_QUERY_COUNT];
+        double start = mvdb_now();
+
+        if (write(fd, query, strlen(query)) < 0 || !loadgen_readReply(in))
+        {
+            break;
+        }
+
+        worker->latencies[worker->answered++] = (mvdb_now() - start) * 1e6;
+    }
+
+    write(fd, "QUIT\n", 5);
+    loadgen_readReply(in);
+    fclose(in);
+
+    return NULL;
+}
+
+static int loadgen_compare(const void* a, const void* b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+
+    return (x > y) - (x < y);
+}
+
+int loadgen_run(const char* path, int clients, int requests)
+{
+    Worker* workers = (Worker*)mvdb_alloc(clients * sizeof(Worker));
+    double* latencies = (double*)mvdb_alloc((size_t)clients * requests
+            * sizeof(double));
+
+    double start = mvdb_now();
+
+    for (int c = 0; c < clients; c++)
+    {
+        workers[c].path = path;
+        workers[c].requests = requests;
+        workers[c].latencies = latencies + (size_t)c * requests;
+        pthread_create(&workers[c].thread, NULL, loadgen_worker, &workers[c]);
+    }
+
+    long answered = 0;
+
+    for (int c = 0; c < clients; c++)
+    {
+        pthread_join(workers[c].thread, NULL);
+
+        /* Pack every worker's samples together for the percentiles */
+        memmove(latencies + answered, workers[c].latencies,
+                workers[c].answered * sizeof(double));
+        answered += workers[c].answered;
+    }
+
+    double seconds = mvdb_now() - start;
+
+    if (answered > 0)
+    {
+        qsort(latencies, answered, sizeof(double), loadgen_compare);
+
+        printf("Load generator: %ld requests over %d clients in %.3fs\n",
+                answered, clients, seconds);
+        printf("Throughput: %.0f requests/s\n", answered / seconds);
+        printf("Round trip: p50 %.1fus, p99 %.1fus\n",
+                latencies[(answered - 1) * 50 / 100],
+                latencies[(answered - 1) * 99 / 100]);
+    }
+
+    int complete = answered == (long)clients * requests;
+
+    if (!complete)
+    {
+        fprintf(stderr, "Error: only %ld of %ld requests were answered by "
+                "'%s'\n", answered, (long)clients * requests, path);
+    }
+
+    free(latencies);
+    free(workers);
+
+    return complete ? EXIT_SUCCESS : EXIT_FAILURE;
+}
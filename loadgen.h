@@ -0,0 +1,46 @@
+/*
+ * File         : loadgen.h
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Header file that defines a load generator for the query
+ *                server in server.h. It opens a number of concurrent client
+ *                connections, replays a fixed mix of queries and reports the
+ *                throughput and round trip latency seen by the clients.
+ *
+ * History      : 19/10/2026 v1.00
+ */
+
+#ifndef LOADGEN_H
+#define LOADGEN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+
+Procedure   : loadgen_run
+
+Parameters  : const char* path - file system path of the server socket
+              int clients - number of concurrent connections to open
+              int requests - number of requests each connection sends
+
+Returns     : int - EXIT_SUCCESS if every request was answered, otherwise
+                    EXIT_FAILURE
+
+Description : Starts one thread per connection. Each thread sends its requests
+              one at a time, cycling through GENRE, TOP, RANGE and TITLE
+              queries, and times every round trip. Prints requests per second
+              and the p50/p99 round trip latency once all threads finish.
+
+ ******************************************************************************/
+int loadgen_run(const char* path, int clients, int requests);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOADGEN_H */
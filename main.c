@@ -12,13 +12,62 @@
  * History      : 27/10/2016 v1.00
  *                10/11/2016 v1.10 - added Scrape method, functionality added
  *                16/11/2016 v1.20 - added comments, cleaned up code
+ *                19/10/2026 v1.30 - added serve and loadgen modes
+ *                19/10/2026 v1.40 - added stream mode
+ *                19/10/2026 v1.50 - uses the specialised list_sortBy<Key> sorts
+ *                19/10/2026 v1.60 - added groupby mode
+ *                19/10/2026 v1.70 - rejected rows are written to films.rej
+ *                19/10/2026 v1.80 - added catalogue and report modes
+ *                19/10/2026 v1.90 - added load mode
+ *                19/10/2026 v2.00 - added stats mode
+ *                19/10/2026 v2.10 - added lazy mode
+ *                19/10/2026 v2.20 - added memory mode; search results are freed
+ *                19/10/2026 v2.30 - added similar mode
+ *                19/10/2026 v2.40 - films.rej is written only by the report,
+ *                                   stream, load, catalogue and memory modes
+ *                19/10/2026 v2.50 - allocation through mvdb.h
+ *
+ * Usage        : c_coursework                   run the fixed report
+ *                c_coursework stream [batch]    run the report in fixed memory
+ *                c_coursework catalogue [file]  save films.txt as a compressed
+ *                                               catalogue (films.mvc)
+ *                c_coursework report <file>     run the report on a catalogue
+ *                c_coursework load [cold]       time the pipelined loader, 
+ *                                               optionally from a cold cache
+ *                c_coursework stats             print sketched dashboard 
+ *                                               figures
+ *                c_coursework lazy              run the report, decoding each
+ *                                               field only when first read
+ *                c_coursework memory [low]      run the report, then print 
+ *                                               the memory used; low searches
+ *                                               without result lists
+ *                c_coursework similar <title> [k]
+ *                                               list the k films most like
+ *                                               title (10 by default)
+ *                c_coursework groupby <key> [key]
+ *                                               aggregate by rating, genre or
+ *                                               decade
+ *                c_coursework serve [socket]    answer queries over a socket
+ *                c_coursework loadgen [socket] [clients] [requests]
+ *                                               benchmark a running server
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include "moviedatabase.h"
 #include "film.h"
+#include "server.h"
+#include "loadgen.h"
+#include "stream.h"
+#include "groupby.h"
+#include "catalogue.h"
+#include "loader.h"
+#include "sketch.h"
+#include "parser.h"
+#include "similar.h"
+#include "mvdb.h"
 
 Film chronologicalOrder(List* list);
 
@@ -32,8 +81,72 @@ Film shortestTitle(List* list);
 
 void deleteR(List* list);
 
+void report(List* list);
+
+int catalogueReport(const char* path);
+
+int saveCatalogue(List* list, const char* path);
+
+int similarFilms(List* list, const char* title, int k);
+
+/*
+ * Set by "memory low": the genre searches walk the list in place rather than
+ * collecting their films into temporary lists.
+ */
+static int lowMemory = 0;
+
+/*
+ * Modes that only query the films read films.txt without writing films.rej,
+ * so the reject file the last report wrote is kept.
+ */
+static const char* queryModes[] = { "serve", "groupby", "similar", "stats" };
+
+static FILE* openRejects(int argc, char** argv)
+{
+    int modes = (int)(sizeof(queryModes) / sizeof(queryModes[0]));
+    
+    for (int m = 0; argc > 1 && m < modes; m++)
+    {
+        if (strcmp(argv[1], queryModes[m]) == 0)
+        {
+            return NULL;
+        }
+    }
+    
+    FILE* rejects = fopen("films.rej", "w");
+    
+    if (rejects == NULL)
+    {
+        printf("Error: unable to open 'films.rej' in mode 'w'\n");
+        
+        exit(EXIT_FAILURE);
+    }
+    
+    return rejects;
+}
+
+static void closeRejects(FILE* rejects)
+{
+    if (rejects != NULL)
+    {
+        fclose(rejects);
+    }
+}
+
 int main(int argc, char** argv) 
 {
+    if (argc > 1 && strcmp(argv[1], "loadgen") == 0)
+    {
+        return loadgen_run(argc > 2 ? argv[2] : SERVER_SOCKET,
+                argc > 3 ? atoi(argv[3]) : 4, 
+                argc > 4 ? atoi(argv[4]) : 10000);
+    }
+    
+    if (argc > 2 && strcmp(argv[1], "report") == 0)
+    {
+        return catalogueReport(argv[2]);
+    }
+    
     FILE*input = fopen("films.txt", "r");
     
     if(input == NULL)
@@ -43,8 +156,112 @@ int main(int argc, char** argv)
         exit(EXIT_FAILURE);
     }
     
-    List* list = list_populate(input);
+    if (argc > 1 && strcmp(argv[1], "lazy") == 0)
+    {
+        report(list_populateLazy(input));
+        
+        return (EXIT_SUCCESS);
+    }
+    
+    FILE* rejects = openRejects(argc, argv);
+    
+    if (argc > 1 && strcmp(argv[1], "stream") == 0)
+    {
+        int result = stream_report(input, 
+                argc > 2 ? atoi(argv[2]) : STREAM_BATCH, rejects);
+        
+        closeRejects(rejects);
+        
+        return result;
+    }
+    
+    if (argc > 1 && strcmp(argv[1], "load") == 0)
+    {
+        LoaderStats stats;
+        
+        if (argc > 2 && strcmp(argv[2], "cold") == 0)
+        {
+            loader_evict(input);
+        }
+        
+        loader_populate(input, rejects, &stats);
+        closeRejects(rejects);
+        loader_print(&stats);
+        
+        return (EXIT_SUCCESS);
+    }
+    
+    List* list = list_populateRejects(input, rejects);
+    
+    closeRejects(rejects);
+    
+    if (argc > 1 && strcmp(argv[1], "serve") == 0)
+    {
+        return server_run(list, argc > 2 ? argv[2] : SERVER_SOCKET);
+    }
+    
+    if (argc > 1 && strcmp(argv[1], "catalogue") == 0)
+    {
+        return saveCatalogue(list, argc > 2 ? argv[2] : CATALOGUE_FILE);
+    }
+    
+    if (argc > 1 && strcmp(argv[1], "groupby") == 0)
+    {
+        GroupKey primary = groupby_key(argc > 2 ? argv[2] : NULL);
+        
+        if (primary == GROUP_NONE)
+        {
+            printf("\nError: group by 'rating', 'genre' or 'decade'\n");
+            
+            exit(EXIT_FAILURE);
+        }
+        
+        GroupResult* result = groupby_run(list, primary, 
+                groupby_key(argc > 3 ? argv[3] : NULL),
+                (int)sysconf(_SC_NPROCESSORS_ONLN));
+        
+        groupby_print(result);
+        groupby_free(result);
+        
+        return (EXIT_SUCCESS);
+    }
+    
+    if (argc > 1 && strcmp(argv[1], "memory") == 0)
+    {
+        ListMemory memory = { 0 };
+        
+        lowMemory = argc > 2 && strcmp(argv[2], "low") == 0;
+        report(list);
+        
+        printf("\n\nMemory used%s:\n", lowMemory ? " (low memory)" : "");
+        list_memory(list, &memory);
+        list_printMemory(&memory);
+        
+        return (EXIT_SUCCESS);
+    }
+    
+    if (argc > 2 && strcmp(argv[1], "similar") == 0)
+    {
+        return similarFilms(list, argv[2], argc > 3 ? atoi(argv[3]) : 10);
+    }
+    
+    if (argc > 1 && strcmp(argv[1], "stats") == 0)
+    {
+        Sketch* sketch = sketch_new(list);
+        
+        sketch_print(sketch);
+        sketch_free(sketch);
+        
+        return (EXIT_SUCCESS);
+    }
+    
+    report(list);
     
+    return (EXIT_SUCCESS);
+}
+
+void report(List* list)
+{
     chronologicalOrder(list);
     
     filmNoirSearch(list);
@@ -56,14 +273,66 @@ int main(int argc, char** argv)
     shortestTitle(list);
     
     deleteR(list);
+}
+
+int catalogueReport(const char* path)
+{
+    FILE* input = fopen(path, "rb");
+    
+    if (input == NULL)
+    {
+        printf("Error: unable to open '%s' in mode 'rb'\n", path);
+        
+        exit(EXIT_FAILURE);
+    }
+    
+    List* list = list_populateCatalogue(input);
+    
+    fclose(input);
+    
+    if (list == NULL)
+    {
+        exit(EXIT_FAILURE);
+    }
+    
+    report(list);
     
     return (EXIT_SUCCESS);
 }
 
+int saveCatalogue(List* list, const char* path)
+{
+    FILE* output = fopen(path, "wb");
+    
+    if (output == NULL)
+    {
+        printf("\nError: unable to open '%s' in mode 'wb'\n", path);
+        
+        exit(EXIT_FAILURE);
+    }
+    
+    int result = catalogue_writeList(output, list);
+    long size = ftell(output);
+    
+    fclose(output);
+    
+    if (result != EXIT_SUCCESS)
+    {
+        printf("\nError: unable to write '%s'\n", path);
+        
+        return result;
+    }
+    
+    printf("\nWrote %d films to %s (%ld bytes)\n", list_length(list), path,
+            size);
+    
+    return result;
+}
+
 Film chronologicalOrder(List* list)
 {
     printf("\nOffline MVDB in Chronological Order (oldest to newest):");
-    list_sortBy(list, list_year);
+    list_sortByYear(list);
     list_printAll(list);
 }
     
@@ -72,23 +341,45 @@ Film filmNoirSearch(List* list)
 {
     int index = 3;
     printf("\nThe Third Longest Film-Noir film is: ");
-    list_sortBy(list, list_lengthS);
-    list_printSelect(list_searchFilmNoir(list), index);
+    list_sortByLength(list);
+    
+    if (lowMemory)
+    {
+        list_printSelectGenre(list, "Film-Noir", index);
+    }
+    else
+    {
+        List* results = list_searchFilmNoir(list);
+        
+        list_printSelect(results, index);
+        list_free(results);
+    }
 }
 
 Film sciFiSearch(List* list)
 {
     int index = 10;
     printf("\nThe Tenth Highest Rated Sci-Fi Film is: ");
-    list_sortBy(list, list_reviewRating);
-    list_printSelect(list_searchSciFi(list), index);
+    list_sortByReviewRating(list);
+    
+    if (lowMemory)
+    {
+        list_printSelectGenre(list, "Sci-Fi", index);
+    }
+    else
+    {
+        List* results = list_searchSciFi(list);
+        
+        list_printSelect(results, index);
+        list_free(results);
+    }
 }
 
 Film highestRated(List* list)
 {
     int index = 1;
     printf("\nThe Highest Rated Film is: ");
-    list_sortBy(list, list_reviewRating);
+    list_sortByReviewRating(list);
     list_printSelect(list, index);
 }
 
@@ -103,4 +394,46 @@ void deleteR(List* list)
 {
     list_deleteRFilms(list);
     list_printAll(list);
-}
\ No newline at end of file
+}
+
+int similarFilms(List* list, const char* title, int k)
+{
+    Film* film = NULL;
+    
+    for (Iterator i = list_begin(list); i != list_end(list) && film == NULL;
+            i = iterator_next(i))
+    {
+        if (strcmp(film_getTitle(iterator_value(i)), title) == 0)
+        {
+            film = iterator_value(i);
+        }
+    }
+    
+    if (film == NULL)
+    {
+        printf("\nError: no film titled '%s'\n", title);
+        
+        return (EXIT_FAILURE);
+    }
+    
+    Similar* index = similar_new(list);
+    SimilarMatch* matches = (SimilarMatch*)mvdb_alloc(
+            (k > 0 ? k : 1) * sizeof(SimilarMatch));
+    
+    int found = similar_top(index, film, k, matches);
+    
+    printf("\nFilms most like %s (%d, %s):\n", film_getTitle(film),
+            film_getYear(film), film_getGenre(film));
+    
+    for (int m = 0; m < found; m++)
+    {
+        printf("%6.3f  %s (%d, %s)\n", matches[m].distance,
+                film_getTitle(matches[m].film), film_getYear(matches[m].film),
+                film_getGenre(matches[m].film));
+    }
+    
+    free(matches);
+    similar_free(index);
+    
+    return (EXIT_SUCCESS);
+}
@@ -0,0 +1,183 @@
+/*
+ * File         : match.c
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Source file that implements the token and certificate
+ *                matching described in match.h.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - match_exactScalar stops at the end of the
+ *                                   buffer.
+ */
+
+#include <string.h>
+
+#include "match.h"
+
+#if !defined(MATCH_SCALAR) && defined(__AVX2__)
+#include <immintrin.h>
+#define MATCH_WIDTH 32
+
+typedef __m256i MatchVector;
+
+static inline MatchVector match_load(const char* bytes)
+{
+    return _mm256_loadu_si256((const __m256i*)bytes);
+}
+
+static inline MatchVector match_fill(char c)
+{
+    return _mm256_set1_epi8(c);
+}
+
+/*
+ * Bit i is set where byte i of a and b are equal.
+ */
+static inline unsigned int match_equal(MatchVector a, MatchVector b)
+{
+    return (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b));
+}
+#elif !defined(MATCH_SCALAR) && defined(__SSE2__)
+#include <emmintrin.h>
+#define MATCH_WIDTH 16
+
+typedef __m128i MatchVector;
+
+static inline MatchVector match_load(const char* bytes)
+{
+    return _mm_loadu_si128((const __m128i*)bytes);
+}
+
+static inline MatchVector match_fill(char c)
+{
+    return _mm_set1_epi8(c);
+}
+
+static inline unsigned int match_equal(MatchVector a, MatchVector b)
+{
+    return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(a, b));
+}
+#endif
+
+/*
+ * Whether the token starting at p is token. strncmp stops at the end of p,
+ * so p[length] is only read when p is at least that long.
+ */
+static inline int match_at(const char* p, const char* token, size_t length)
+{
+    return strncmp(p, token, length) == 0
+            && (p[length] == '/' || p[length] == '\0');
+}
+
+/*
+ * Tries every token of text that starts at or after at.
+ */
+static int match_from(const char* text, size_t size, size_t at,
+        const char* token, size_t length)
+{
+    for (size_t i = at; i < size && text[i] != '\0'; i++)
+    {
+        if ((i == 0 || text[i - 1] == '/') && match_at(text + i, token, length))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int match_tokenScalar(const char* text, size_t size, const char* token)
+{
+    size_t length = strlen(token);
+
+    return length == 0 || match_from(text, size, 0, token, length);
+}
+
+int match_exactScalar(const char* text, size_t size, const char* value)
+{
+    size_t length = strlen(value);
+
+    /* A value that cannot fit in the buffer is never held in it */
+    return length < size && memcmp(text, value, length + 1) == 0;
+}
+
+int match_token(const char* text, size_t size, const char* token)
+{
+#ifdef MATCH_WIDTH
+    size_t length = strlen(token);
+
+    if (length == 0)
+    {
+        return 1;
+    }
+
+    MatchVector first = match_fill(token[0]);
+    MatchVector slash = match_fill('/');
+    MatchVector end = match_fill('\0');
+    unsigned int carry = 1;
+    size_t at;
+
+    for (at = 0; at + MATCH_WIDTH <= size; at += MATCH_WIDTH)
+    {
+        MatchVector bytes = match_load(text + at);
+        unsigned int slashes = match_equal(bytes, slash);
+        unsigned int ends = match_equal(bytes, end);
+
+        /* A token starts after a '/', or at the very start (carry) */
+        unsigned int starts = match_equal(bytes, first)
+                & (slashes << 1 | carry);
+
+        if (ends != 0)
+        {
+            starts &= (ends & -ends) - 1;
+        }
+
+        for (; starts != 0; starts &= starts - 1)
+        {
+            if (match_at(text + at + __builtin_ctz(starts), token, length))
+            {
+                return 1;
+            }
+        }
+
+        if (ends != 0)
+        {
+            return 0;
+        }
+
+        carry = slashes >> (MATCH_WIDTH - 1);
+    }
+
+    return match_from(text, size, at, token, length);
+#else
+    return match_tokenScalar(text, size, token);
+#endif
+}
+
+int match_exact(const char* text, size_t size, const char* value)
+{
+#ifdef MATCH_WIDTH
+    size_t length = strlen(value);
+
+    /* Certificates fit in one 16 byte compare, even with AVX2 */
+    if (length < 16 && size >= 16)
+    {
+        char padded[16] = { 0 };
+
+        memcpy(padded, value, length);
+
+        __m128i a = _mm_loadu_si128((const __m128i*)text);
+        __m128i b = _mm_loadu_si128((const __m128i*)padded);
+        unsigned int same = (unsigned int)_mm_movemask_epi8(
+                _mm_cmpeq_epi8(a, b));
+        unsigned int need = (1u << (length + 1)) - 1;
+
+        return (same & need) == need;
+    }
+#endif
+
+    return match_exactScalar(text, size, value);
+}
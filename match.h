@@ -0,0 +1,89 @@
+/*
+ * File         : match.h
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Header file that defines exact matching of genre tokens and
+ *                certificates in fixed size string buffers. A genre such as
+ *                "Crime/Drama/Film-Noir" is a list of tokens separated by
+ *                "/", and a genre matches only when one of its tokens is the
+ *                whole of the token asked for. A certificate matches only
+ *                when it is the same string. (strstr matched parts of words,
+ *                so "R" matched "NOT RATED" and "APPROVED".)
+ *
+ *                The buffers are scanned a vector at a time: 32 bytes with
+ *                AVX2, 16 with SSE2, chosen when compiled. Building with
+ *                -DMATCH_SCALAR, or for a machine with neither, uses the
+ *                scalar versions, which are always built and give the same
+ *                answers.
+ *
+ * History      : 19/10/2026 v1.00
+ */
+
+#ifndef MATCH_H
+#define MATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+/*******************************************************************************
+
+Procedure   : match_token
+
+Parameters  : const char* text - "/" separated tokens
+              size_t size - bytes that may be read from text, at least up to
+                            and including its terminating '\0'
+              const char* token - the token wanted
+
+Returns     : int - 1 if token is one of the tokens of text, else 0. An empty
+                    token matches everything, as strstr did.
+
+Description : Finds the first letter of token at the start of a token, a
+              vector of bytes at a time, and compares the rest only there.
+
+ ******************************************************************************/
+int match_token(const char* text, size_t size, const char* token);
+
+/*******************************************************************************
+
+Procedure   : match_exact
+
+Parameters  : const char* text - a string
+              size_t size - bytes that may be read from text, at least up to
+                            and including its terminating '\0'
+              const char* value - the string wanted
+
+Returns     : int - 1 if text and value are the same string, else 0
+
+Description : For a value of up to 15 characters in a buffer of at least 16
+              bytes, as certificates are, compares both strings with one
+              vector compare; otherwise as strcmp.
+
+ ******************************************************************************/
+int match_exact(const char* text, size_t size, const char* value);
+
+/*******************************************************************************
+
+Procedure   : match_tokenScalar, match_exactScalar
+
+Parameters  : as match_token and match_exact
+
+Returns     : as match_token and match_exact
+
+Description : The byte at a time versions, used where the vector versions
+              cannot be and kept to check them against.
+
+ ******************************************************************************/
+int match_tokenScalar(const char* text, size_t size, const char* token);
+int match_exactScalar(const char* text, size_t size, const char* value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MATCH_H */
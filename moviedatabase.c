@@ -15,111 +15,407 @@
  * History      : 27/10/2016 v1.00
  *                10/11/2016 v1.10 - Functionality added
  *                16/11/2016 v1.20 - Comments added, code cleaned up.
+ *                19/10/2026 v1.30 - list_populate keeps its own list.
+ *                19/10/2026 v1.40 - list_deleteRFilms unlinks the nodes it frees.
+ *                19/10/2026 v1.50 - Specialised list_sortBy<Key> functions, 
+ *                                   list_title compares against the next film.
+ *                19/10/2026 v1.60 - list_populate uses the validating parser.
+ *                19/10/2026 v1.70 - (title, year) index, list_find, list_upsert
+ *                                   and list_dedupe.
+ *                19/10/2026 v1.80 - Changes are recorded in the list's journal.
+ *                19/10/2026 v1.90 - Unrolled list: films are held in blocks of
+ *                                   LIST_SLOTS.
+ *                19/10/2026 v2.00 - Films are read through their get methods.
+ *                19/10/2026 v2.10 - Memory accounting, temporary result lists
+ *                                   and list_findGenre.
+ *                19/10/2026 v2.20 - list_printSelect and list_printSelectGenre
+ *                                   stop at the end of the list.
+ *                19/10/2026 v2.30 - Temporary list bytes counted atomically.
+ *                19/10/2026 v2.40 - Memory allocated through mvdb.h.
+ *                19/10/2026 v2.50 - "No such film" printed by film_printFound.
+ *                19/10/2026 v2.60 - Indexed lists keep a journal so changed
+ *                                   titles and years are re-keyed.
+ *                19/10/2026 v2.70 - list_memory measures fields of lazily
+ *                                   loaded films that are not decoded yet.
+ *                19/10/2026 v2.80 - Blocks allocated through mvdb_alignedAlloc.
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdatomic.h>
 
 #include "moviedatabase.h"
+#include "mvdb.h"
+#include "parser.h"
 
 List* list_populate(FILE* input)
 {
-    char line[255];
-    char title[100];
-    int year;
-    char rating[50];
-    char genre[100];
-    int length;
-    float reviewRating;
-    list = list_new();
+    return list_populateRejects(input, stderr);
+}
+
+List* list_populateRejects(FILE* input, FILE* rejects)
+{
+    Parser parser;
+    FilmRecord record;
+    List* list = list_new();
     
-    while(fgets(line, 255, input) != NULL)
+    parser_init(&parser, input, rejects);
+    
+    while(parser_next(&parser, &record))
     {
-        sscanf(line, "\"%[^\",]\",%d,\"%[^\",]\",\"%[^\",]\",%d,%f\n", title, 
-            &year, rating, genre, &length, &reviewRating);
-        
-        Film * f = film_new(title, year, rating , genre, length, reviewRating);
-        
-        list_add(list, f);  
+        list_add(list, film_fromRecord(&record));  
     }
     printf("Films successfully read into MVDB: %i", list_length(list));
+    
+    if (parser.rejected > 0)
+    {
+        printf(" (%ld rows rejected)", parser.rejected);
+    }
+    
+    parser_free(&parser);
     return list;
     
 }
 
 List* list_new()
 {
-    List* list = (List*)malloc(sizeof(List));
+    List* list = (List*)mvdb_alloc(sizeof(List));
+    
+    list->first = NULL;
+    list->last = NULL;
+    list->index = NULL;
+    list->journal = NULL;
+    list->temporary = 0;
     
-    if (list == NULL)
+    return list;
+}
+
+/*
+ * Bytes held by temporary lists, and the most they have ever held. Searches
+ * on several threads (search_run) make and free temporary lists at the same
+ * time, so both are atomic.
+ */
+static _Atomic size_t list_resultBytes = 0;
+static _Atomic size_t list_resultPeak = 0;
+
+static void list_account(const List* list, long bytes)
+{
+    if (list->temporary)
     {
-        fprintf(stderr, "Error: Unable to allocate memory in list_new()\n");
+        size_t now = atomic_fetch_add_explicit(&list_resultBytes,
+                (size_t)bytes, memory_order_relaxed) + (size_t)bytes;
+        size_t peak = atomic_load_explicit(&list_resultPeak,
+                memory_order_relaxed);
         
-        exit(EXIT_FAILURE);
+        /* A failed exchange reloads peak, so this stops once it is >= now */
+        while (now > peak && !atomic_compare_exchange_weak_explicit(
+                &list_resultPeak, &peak, now, memory_order_relaxed,
+                memory_order_relaxed))
+        {
+        }
     }
+}
+
+List* list_newTemporary()
+{
+    List* list = list_new();
     
-    list->first = NULL;
-    list->last = NULL;
+    list->temporary = 1;
+    list_account(list, sizeof(List));
     
     return list;
 }
 
-void list_add(List* list, Film* value)
+_Static_assert(sizeof(MvdbBlock) <= LIST_BLOCK, "MvdbBlock larger than LIST_BLOCK");
+
+static MvdbBlock* list_newBlock(List* list)
 {
-    Mvdb* node = (Mvdb*)malloc(sizeof(Mvdb));
+    MvdbBlock* block = (MvdbBlock*)mvdb_alignedAlloc(LIST_BLOCK, LIST_BLOCK);
     
-    if (node == NULL)
+    block->next = NULL;
+    block->count = 0;
+    list_account(list, LIST_BLOCK);
+    
+    return block;
+}
+
+static void list_freeBlock(List* list, MvdbBlock* block)
+{
+    list_account(list, -LIST_BLOCK);
+    free(block);
+}
+
+/*
+ * Moves a film to its new key when its title or year is changed through the
+ * film_set methods.
+ */
+static void list_rekey(void* context, const JournalEntry* entry)
+{
+    List* list = (List*)context;
+    
+    if (list->index != NULL && entry->op == JOURNAL_UPDATE
+            && (entry->field == FILM_TITLE || entry->field == FILM_YEAR))
     {
-        fprintf(stderr, "Error: Unable to allocate memory in list_add()\n");
+        filmindex_rekey(list->index, entry->film);
+    }
+}
+
+Journal* list_journal(List* list)
+{
+    if (list->journal == NULL)
+    {
+        list->journal = journal_new();
+        journal_listen(list->journal, list_rekey, list);
         
-        exit(EXIT_FAILURE);
+        for (MvdbBlock* block = list->first; block != NULL; 
+                block = block->next)
+        {
+            for (int s = 0; s < block->count; s++)
+            {
+                block->values[s]->journal = list->journal;
+            }
+        }
     }
     
-    node->value = value;
-    node->next = NULL;
+    return list->journal;
+}
+
+/*
+ * Bookkeeping shared by everything that adds a film to, or takes a film out 
+ * of, the list.
+ */
+static void list_added(List* list, Film* value)
+{
+    if (list->index != NULL)
+    {
+        filmindex_put(list->index, value);
+    }
+    if (list->journal != NULL)
+    {
+        value->journal = list->journal;
+        journal_append(list->journal, JOURNAL_INSERT, value, FILM_TITLE);
+    }
+}
+
+static void list_removed(List* list, Film* value)
+{
+    if (list->index != NULL)
+    {
+        filmindex_remove(list->index, value);
+    }
+    if (list->journal != NULL && value->journal == list->journal)
+    {
+        journal_append(list->journal, JOURNAL_DELETE, value, FILM_TITLE);
+        value->journal = NULL;
+    }
+}
+
+/*
+ * Builds the index from the films already held. Where a key is held twice
+ * the first film is the one indexed. The list's journal is started too, so
+ * the films report changes to their keys.
+ */
+static FilmIndex* list_indexed(List* list)
+{
+    if (list->index == NULL)
+    {
+        list_journal(list);
+        list->index = filmindex_new(list_length(list));
+        
+        for (MvdbBlock* block = list->first; block != NULL; 
+                block = block->next)
+        {
+            for (int s = 0; s < block->count; s++)
+            {
+                filmindex_put(list->index, block->values[s]);
+            }
+        }
+    }
     
-    if (list->last == NULL)
+    return list->index;
+}
+
+/*
+ * Passes that drop films keep the rest in order by packing them into the 
+ * front of the blocks they were read from: list_keep is called for each film
+ * kept, then list_pack frees the blocks left empty. The packer never gets 
+ * ahead of the pass reading the films.
+ */
+typedef struct _ListPacker
+{
+    MvdbBlock* block;
+    int used;
+}ListPacker;
+
+static void list_keep(ListPacker* packer, Film* value)
+{
+    if (packer->used == LIST_SLOTS)
+    {
+        packer->block->count = LIST_SLOTS;
+        packer->block = packer->block->next;
+        packer->used = 0;
+    }
+    
+    packer->block->values[packer->used++] = value;
+}
+
+static void list_pack(List* list, ListPacker* packer)
+{
+    MvdbBlock* spare;
+    
+    if (packer->used == 0)
     {
-        list->first = list->last = node;
+        spare = list->first;
+        list->first = list->last = NULL;
     }
     else
     {
-        list->last = list->last->next = node;
+        spare = packer->block->next;
+        packer->block->count = packer->used;
+        packer->block->next = NULL;
+        list->last = packer->block;
+    }
+    
+    while (spare != NULL)
+    {
+        MvdbBlock* next = spare->next;
+        
+        list_freeBlock(list, spare);
+        spare = next;
     }
 }
 
-void list_insert(List* list, Film* value)
+static void list_fold(Film* into, Film* from, ListUpsert mode)
+{
+    if (mode == LIST_REPLACE || film_getRating(from)[0] != '\0')
+    {
+        film_setRating(into, (char*)film_getRating(from));
+    }
+    if (mode == LIST_REPLACE || film_getGenre(from)[0] != '\0')
+    {
+        film_setGenre(into, (char*)film_getGenre(from));
+    }
+    if (mode == LIST_REPLACE || film_getLength(from) != 0)
+    {
+        film_setLength(into, film_getLength(from));
+    }
+    if (mode == LIST_REPLACE || film_getReviewRating(from) != 0)
+    {
+        film_setReviewRating(into, film_getReviewRating(from));
+    }
+}
+
+Film* list_find(List* list, const char* title, int year)
 {
-    Mvdb* node = (Mvdb*)malloc(sizeof(Mvdb));
+    return filmindex_find(list_indexed(list), title, year);
+}
+
+int list_upsert(List* list, Film* value, ListUpsert mode)
+{
+    Film* held = filmindex_put(list_indexed(list), value);
     
-    if (node == NULL)
+    if (held == NULL)
     {
-        fprintf(stderr, "Error: Unable to allocate memory in list_insert()\n");
+        list_add(list, value);
         
-        exit(EXIT_FAILURE);
+        return 1;
     }
     
-    node->value = value;
-    node->next = list->first;
+    list_fold(held, value, mode);
+    film_free(value);
     
-    if (list->first == NULL)
+    return 0;
+}
+
+int list_dedupe(List* list, ListUpsert mode)
+{
+    ListPacker packer = { list->first, 0 };
+    int removed = 0;
+    
+    list_journal(list);
+    filmindex_free(list->index);
+    list->index = filmindex_new(list_length(list));
+    
+    for (MvdbBlock* block = list->first; block != NULL; block = block->next)
     {
-        list->first = list->last = node;
+        for (int s = 0; s < block->count; s++)
+        {
+            Film* value = block->values[s];
+            Film* held = filmindex_put(list->index, value);
+            
+            if (held != NULL)
+            {
+                list_fold(held, value, mode);
+                list_removed(list, value);
+                film_free(value);
+                removed++;
+            }
+            else
+            {
+                list_keep(&packer, value);
+            }
+        }
     }
-    else
+    
+    list_pack(list, &packer);
+    
+    return removed;
+}
+
+void list_add(List* list, Film* value)
+{
+    if (list->last == NULL || list->last->count == LIST_SLOTS)
     {
-        list->first = node;
+        MvdbBlock* block = list_newBlock(list);
+        
+        if (list->last == NULL)
+        {
+            list->first = block;
+        }
+        else
+        {
+            list->last->next = block;
+        }
+        
+        list->last = block;
+    }
+    
+    list->last->values[list->last->count++] = value;
+    
+    list_added(list, value);
+}
+
+void list_insert(List* list, Film* value)
+{
+    MvdbBlock* block = list->first;
+    
+    if (block == NULL || block->count == LIST_SLOTS)
+    {
+        block = list_newBlock(list);
+        block->next = list->first;
+        list->first = block;
+        
+        if (list->last == NULL)
+        {
+            list->last = block;
+        }
     }
+    
+    memmove(block->values + 1, block->values, block->count * sizeof(Film*));
+    block->values[0] = value;
+    block->count++;
+    
+    list_added(list, value);
 }
 
 int list_length(List* list)
 {
     int length = 0;
     
-    for (Mvdb* node = list->first; node != NULL; node = node->next)
+    for (MvdbBlock* block = list->first; block != NULL; block = block->next)
     {
-        length++;
+        length += block->count;
     }
     
     return length;
@@ -134,21 +430,26 @@ Film* list_head(List* list)
         exit(EXIT_FAILURE);
     }
     
-    Film* value = list->first->value;
+    MvdbBlock* block = list->first;
+    Film* value = block->values[0];
     
-    Mvdb *node = list->first;
+    list_removed(list, value);
     
-    if (list->first == list->last)
-    {
-        list->first = list->last = NULL;
-    }
-    else
+    block->count--;
+    memmove(block->values, block->values + 1, block->count * sizeof(Film*));
+    
+    if (block->count == 0)
     {
-        list->first = list->first->next;
+        list->first = block->next;
+        
+        if (list->last == block)
+        {
+            list->last = NULL;
+        }
+        
+        list_freeBlock(list, block);
     }
     
-    free(node);
-    
     return value;
 }
 
@@ -161,46 +462,57 @@ Film* list_tail(List* list)
         exit(EXIT_FAILURE);
     }
     
-    Film* value = list->last->value;
+    MvdbBlock* tail = list->last;
+    Film* value = tail->values[tail->count - 1];
     
-    Mvdb* tail = list->last;
+    list_removed(list, value);
     
-    if (list->first == list->last)
+    if (--tail->count == 0)
     {
-        list->first = list->last = NULL;
-    }
-    else
-    {
-        Mvdb* node;
-        
-        for (node = list->first; node->next != tail; node = node-> next);
+        if (list->first == tail)
+        {
+            list->first = list->last = NULL;
+        }
+        else
+        {
+            MvdbBlock* block;
+            
+            for (block = list->first; block->next != tail; block = block->next);
+            
+            list->last          = block;
+            list->last->next    = NULL;
+        }
         
-        list->last          = node;
-        list->last->next    = NULL;
+        list_freeBlock(list, tail);
     }
     
-    free(tail);
-    
     return value;
 }
 
 void list_sortBy(List* list, int (function)(Mvdb*))
 {
-    if (list->first != list->last) //list contains two or more items
+    if (list->first != NULL)
     {
         int sorted;
+        Mvdb pair[2];
+        
+        pair[0].next = &pair[1];
+        pair[1].next = NULL;
         
         do
         {
             sorted = 1;
             
-            for (Mvdb* node=list->first; node->next!=NULL; node=node->next)
+            for (Iterator i = list_begin(list), next; 
+                    (next = iterator_next(i)) != NULL; i = next)
             {
-                if (function(node))
+                pair[0].value = *i;
+                pair[1].value = *next;
+                
+                if (function(pair))
                 {
-                    Film* temp = node->value;
-                    node->value = node->next->value;
-                    node->next->value = temp;
+                    *i = pair[1].value;
+                    *next = pair[0].value;
                     sorted = 0;
                 }
             }
@@ -209,48 +521,108 @@ void list_sortBy(List* list, int (function)(Mvdb*))
     }
 }
 
+/*
+ * Same bubble sort as list_sortBy, with the key test pasted into the loop. a
+ * is the Film currently being carried down the list.
+ */
+#define LIST_SORT_DEFINE(name, after)                                          \
+void list_sortBy##name(List* list)                                             \
+{                                                                              \
+    if (list->first != NULL)                                                   \
+    {                                                                          \
+        int sorted;                                                            \
+                                                                               \
+        do                                                                     \
+        {                                                                      \
+            sorted = 1;                                                        \
+            Iterator i = list_begin(list);                                     \
+            Iterator next;                                                     \
+            Film* a = *i;                                                      \
+                                                                               \
+            for (; (next = iterator_next(i)) != NULL; i = next)                \
+            {                                                                  \
+                Film* b = *next;                                               \
+                                                                               \
+                if (after)                                                     \
+                {                                                              \
+                    *i = b;                                                    \
+                    *next = a;                                                 \
+                    sorted = 0;                                                \
+                }                                                              \
+                else                                                           \
+                {                                                              \
+                    a = b;                                                     \
+                }                                                              \
+            }                                                                  \
+        }                                                                      \
+        while (!sorted);                                                       \
+    }                                                                          \
+}
+
+LIST_SORT_KEYS(LIST_SORT_DEFINE)
+#undef LIST_SORT_DEFINE
+
 List* list_searchFilmNoir(List* list)
 {
-    List* tempList = list_new();
-    Mvdb* node = list->first;
-    while(node!=NULL)
+    List* tempList = list_newTemporary();
+    
+    for (MvdbBlock* block = list->first; block != NULL; block = block->next)
     {
-        if(strstr(node->value->genre, "Film-Noir"))
+        for (int s = 0; s < block->count; s++)
         {
-            list_add(tempList, node->value);
+            if(film_hasGenre(block->values[s], "Film-Noir"))
+            {
+                list_add(tempList, block->values[s]);
+            }
         }
-        node = node->next;
     }
     return tempList;
 }
 
 List* list_searchSciFi(List* list)
 {
-    List* tempList = list_new();
-    Mvdb* node = list->first;
-    while(node!=NULL)
+    List* tempList = list_newTemporary();
+    
+    for (MvdbBlock* block = list->first; block != NULL; block = block->next)
     {
-        if(strstr(node->value->genre, "Sci-Fi"))
+        for (int s = 0; s < block->count; s++)
         {
-            list_add(tempList, node->value);
+            if(film_hasGenre(block->values[s], "Sci-Fi"))
+            {
+                list_add(tempList, block->values[s]);
+            }
         }
-        node = node->next;
     }
     return tempList;
 }
 
+Iterator list_findGenre(Iterator from, const char* genre)
+{
+    for (Iterator i = from; i != NULL; i = iterator_next(i))
+    {
+        if (film_hasGenre(iterator_value(i), genre))
+        {
+            return i;
+        }
+    }
+    
+    return NULL;
+}
+
 Film* list_sortTitle(List* list)
 {
-    Mvdb* node = list->first;
-    Film* shortTitle = node->value;
+    Film* shortTitle = list->first->values[0];
     printf("\n");
-    while(node != NULL)
+    for (MvdbBlock* block = list->first; block != NULL; block = block->next)
     {
-        if(strlen(node->value->title) < strlen(shortTitle->title))
+        for (int s = 0; s < block->count; s++)
         {
-            shortTitle = node->value;
+            if(strlen(film_getTitle(block->values[s]))
+                    < strlen(film_getTitle(shortTitle)))
+            {
+                shortTitle = block->values[s];
+            }
         }
-        node = node->next;
     }
     
     return shortTitle;
@@ -258,30 +630,68 @@ Film* list_sortTitle(List* list)
 
 void list_deleteRFilms(List* list)
 {
-    Mvdb* node = list->first;
+    ListPacker packer = { list->first, 0 };
     
-    while(node!=NULL)
+    for (MvdbBlock* block = list->first; block != NULL; block = block->next)
     {
-        if(strstr(node->value->rating, "R"))
+        for (int s = 0; s < block->count; s++)
         {
-            film_free(node);
+            Film* value = block->values[s];
+            
+            if(film_isRRated(value))
+            {
+                list_removed(list, value);
+                film_free(value);
+            }
+            else
+            {
+                list_keep(&packer, value);
+            }
         }
-        node = node->next;
     }
+    
+    list_pack(list, &packer);
 }
 
 void list_clear(List *list)
 {
     while (list->first != NULL)
     {
-        Mvdb* node = list->first; 
+        MvdbBlock* block = list->first; 
         
-        list->first = node->next;
+        list->first = block->next;
         
-        free(node);
+        if (list->journal != NULL)
+        {
+            for (int s = 0; s < block->count; s++)
+            {
+                if (block->values[s]->journal == list->journal)
+                {
+                    block->values[s]->journal = NULL;
+                }
+            }
+        }
+        
+        list_freeBlock(list, block);
     }
     
     list->last = NULL;
+    
+    filmindex_free(list->index);
+    list->index = NULL;
+    
+    if (list->journal != NULL)
+    {
+        journal_append(list->journal, JOURNAL_CLEAR, NULL, FILM_TITLE);
+    }
+}
+
+void list_free(List* list)
+{
+    list_clear(list);
+    journal_free(list->journal);
+    list_account(list, -(long)sizeof(List));
+    free(list);
 }
 
 void list_printAll(List* list)
@@ -289,12 +699,13 @@ void list_printAll(List* list)
     printf("\n");
     
     printf("*********************************************************\n");
-    Mvdb* node = list->first;
-    while(node!=NULL)
-    {        
-        printf("----------------------------------------------------------\n");
-        film_print(node->value);
-        node = node->next;
+    for (MvdbBlock* block = list->first; block != NULL; block = block->next)
+    {
+        for (int s = 0; s < block->count; s++)
+        {
+            printf("----------------------------------------------------------\n");
+            film_print(block->values[s]);
+        }
     }
     printf("*********************************************************\n");
 }
@@ -304,21 +715,113 @@ void list_printSelect(List* list, int index)
     printf("\n");
     
     printf("*********************************************************\n");
-    Mvdb* node = list->first;
-    int i = 0;
-    for(int i = 1; i < index; i++)
+    Iterator node = list_begin(list);
+    
+    for (int i = 1; i < index && node != list_end(list); i++)
+    {
+        node = iterator_next(node);
+    }
+   
+    film_printFound(node == NULL ? NULL : iterator_value(node), index);
+
+    printf("*********************************************************\n");
+}
+
+void list_printSelectGenre(List* list, const char* genre, int index)
+{
+    printf("\n");
+    
+    printf("*********************************************************\n");
+    Iterator node = list_findGenre(list_begin(list), genre);
+    
+    for (int i = 1; i < index && node != list_end(list); i++)
     {
-        node = node->next;
+        node = list_findGenre(iterator_next(node), genre);
     }
    
-    film_print(node->value);
+    film_printFound(node == NULL ? NULL : iterator_value(node), index);
 
     printf("*********************************************************\n");
 }
 
+/*
+ * Bytes of a rating or genre buffer that the field uses, counting the 
+ * terminator. A field not yet decoded is measured in the film's record, so a 
+ * lazily loaded film is counted as it will be once decoded.
+ */
+static size_t list_used(const Film* film, FilmField field, const char* value,
+        size_t size)
+{
+    if (film->text == NULL || (film->decoded & (1u << field)))
+    {
+        return strlen(value) + 1;
+    }
+    
+    size_t length = film_measure(film, field);
+    
+    return length < size ? length + 1 : size;
+}
+
+void list_memory(const List* list, ListMemory* memory)
+{
+    const FilmText* text = NULL;
+    
+    memory->nodes += sizeof(List);
+    
+    for (MvdbBlock* block = list->first; block != NULL; block = block->next)
+    {
+        memory->nodes += LIST_BLOCK;
+        
+        for (int s = 0; s < block->count; s++)
+        {
+            const Film* film = block->values[s];
+            
+            memory->films += sizeof(Film);
+            memory->slack += sizeof(film->rating) + sizeof(film->genre)
+                    - list_used(film, FILM_RATING, film->rating,
+                    sizeof(film->rating))
+                    - list_used(film, FILM_GENRE, film->genre,
+                    sizeof(film->genre));
+            
+            if (film->title != NULL)
+            {
+                memory->titles += strlen(film->title) + 1;
+            }
+            
+            if (film->text != NULL && film->text != text)
+            {
+                text = film->text;
+                memory->text += sizeof(FilmText) + text->size;
+            }
+        }
+    }
+    
+    size_t peak = atomic_load(&list_resultPeak);
+    
+    memory->results += atomic_load(&list_resultBytes);
+    memory->peak = peak > memory->peak ? peak : memory->peak;
+    memory->indexes += filmindex_bytes(list->index);
+}
+
+void list_printMemory(const ListMemory* memory)
+{
+    size_t total = memory->films + memory->nodes + memory->titles
+            + memory->text + memory->results + memory->indexes;
+    
+    printf("Film records    %10.1f KB (%.1f KB unused rating and genre)\n",
+            memory->films / 1024.0, memory->slack / 1024.0);
+    printf("List blocks     %10.1f KB\n", memory->nodes / 1024.0);
+    printf("Titles          %10.1f KB\n", memory->titles / 1024.0);
+    printf("Lazy file text  %10.1f KB\n", memory->text / 1024.0);
+    printf("Search results  %10.1f KB (at most %.1f KB)\n",
+            memory->results / 1024.0, memory->peak / 1024.0);
+    printf("Indexes         %10.1f KB\n", memory->indexes / 1024.0);
+    printf("Total           %10.1f KB\n", total / 1024.0);
+}
+
 int list_title(Mvdb* node)
 {
-    if (strlen(node->value->title) > strlen(node->value->title))
+    if (strcmp(film_getTitle(node->value), film_getTitle(node->next->value)) > 0)
     {
         return 1;
     }
@@ -330,7 +833,7 @@ int list_title(Mvdb* node)
 
 int list_year(Mvdb* node)
 {
-    if ((node->value->year > node->next->value->year) > 0)
+    if ((film_getYear(node->value) > film_getYear(node->next->value)) > 0)
     {
         return 1;
     }
@@ -342,7 +845,7 @@ int list_year(Mvdb* node)
 
 int list_rating(Mvdb* node)
 {
-    if (strcmp(node->value->rating, node->next->value->rating) > 0)
+    if (strcmp(film_getRating(node->value), film_getRating(node->next->value)) > 0)
     {
         return 1;
     }
@@ -354,7 +857,7 @@ int list_rating(Mvdb* node)
 
 int list_genre(Mvdb* node)
 {
-    if (strcmp(node->value->genre, node->next->value->genre) > 0)
+    if (strcmp(film_getGenre(node->value), film_getGenre(node->next->value)) > 0)
     {
         return 1;
     }
@@ -366,7 +869,7 @@ int list_genre(Mvdb* node)
 
 int list_lengthS(Mvdb* node)
 {
-    if ((node->value->length < node->next->value->length) > 0)
+    if ((film_getLength(node->value) < film_getLength(node->next->value)) > 0)
     {
         return 1;
     }
@@ -378,7 +881,7 @@ int list_lengthS(Mvdb* node)
 
 int list_reviewRating(Mvdb* node)
 {
-    if ((node->value->reviewRating < node->next->value->reviewRating) > 0)
+    if ((film_getReviewRating(node->value) < film_getReviewRating(node->next->value)) > 0)
     {
         return 1;
     }
@@ -15,6 +15,21 @@
  * History      : 27/10/2016 v1.00
  *                10/11/2016 v1.10 - Functionality added
  *                16/11/2016 v1.20 - Comments added, code cleaned up.
+ *                19/10/2026 v1.30 - Global list removed so the header can be
+ *                                   shared by more than one source file.
+ *                19/10/2026 v1.40 - Specialised list_sortBy<Key> functions.
+ *                19/10/2026 v1.50 - list_populateRejects added.
+ *                19/10/2026 v1.60 - (title, year) index with list_find,
+ *                                   list_upsert and list_dedupe.
+ *                19/10/2026 v1.70 - Change journal, list_journal and list_free.
+ *                19/10/2026 v1.80 - Films held in blocks of LIST_SLOTS (an
+ *                                   unrolled list) instead of a node each.
+ *                19/10/2026 v1.90 - Memory accounting, temporary result lists
+ *                                   and list_findGenre.
+ *                19/10/2026 v2.00 - list_printSelect and list_printSelectGenre
+ *                                   stop at the end of the list.
+ *                19/10/2026 v2.10 - Changing the title or year of an indexed
+ *                                   film moves it to its new key.
  */
 
 #ifndef MOVIEDATABASE_H
@@ -26,30 +41,114 @@ extern "C" {
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
     
 #include "film.h"
+#include "filmindex.h"
+#include "journal.h"
     
+/*
+ * The list is unrolled: films are held LIST_SLOTS at a time in blocks of 
+ * LIST_BLOCK bytes (eight cache lines), so a traversal reads the film 
+ * pointers one after another instead of following a pointer per film. Blocks
+ * are aligned to LIST_BLOCK, which lets an iterator be a plain pointer to a
+ * slot: the block holding it is found by masking the address. Every block 
+ * holds at least one film, and only the first and last may be part full.
+ */
+#define LIST_BLOCK 512
+#define LIST_SLOTS 62
+
+typedef struct _MvdbBlock
+{
+    struct _MvdbBlock* next;
+    int count;
+    Film* values[LIST_SLOTS];
+}MvdbBlock;
+
+/*
+ * A film and the film after it, as passed to the list_sortBy comparators.
+ */
 typedef struct _Mvdb
 {
     Film* value;
     struct _Mvdb* next;
 }Mvdb;
 
+/*
+ * index is NULL until a film is first looked up by key, then kept up to date
+ * by every function that adds or removes films. Building it starts the
+ * journal, through which film_setTitle and film_setYear move a film to its
+ * new key.
+ *
+ * journal is likewise NULL until list_journal() is first called. From then
+ * on films added to or removed from the list, and changes made to them 
+ * through the film_set methods, are recorded in it. Reordering the list is 
+ * not recorded.
+ *
+ * temporary is set for a list made by list_newTemporary to hold search 
+ * results. The bytes such lists hold are counted until they are freed, so a
+ * caller that forgets to free its results shows up in list_memory.
+ */
 typedef struct _List
 {
-    Mvdb* first;
-    Mvdb* last;
+    MvdbBlock* first;
+    MvdbBlock* last;
+    FilmIndex* index;
+    Journal* journal;
+    int temporary;
 }List;
 
-typedef Mvdb* Iterator;
+/*
+ * Bytes of memory held, by what they hold:
+ *   films    - the Film structs
+ *   slack    - the part of films given to rating and genre buffers but not
+ *              used by the strings in them
+ *   nodes    - the List and its blocks
+ *   titles   - title strings
+ *   text     - file text shared by lazily loaded films
+ *   results  - temporary result lists not yet freed, of every list
+ *   peak     - the most results has been since the program started
+ *   indexes  - the (title, year) index, plus anything the caller adds, such
+ *              as view_bytes() of a view or sketch_bytes() of a sketch
+ */
+typedef struct _ListMemory
+{
+    size_t films;
+    size_t slack;
+    size_t nodes;
+    size_t titles;
+    size_t text;
+    size_t results;
+    size_t peak;
+    size_t indexes;
+}ListMemory;
+
+/*
+ * What list_upsert and list_dedupe do with a film whose title and year are
+ * already held: LIST_REPLACE copies every field of the new film over the old
+ * one, LIST_MERGE only copies the certificate, genre, run time and review
+ * rating where the new film has one (not empty or zero).
+ */
+typedef enum _ListUpsert
+{
+    LIST_REPLACE,
+    LIST_MERGE
+}ListUpsert;
+
+typedef Film** Iterator;
 
 
 /*
  * Inline methods to help navigate the linked list.
  */
+static inline MvdbBlock* iterator_block(const Iterator i)
+{
+    return (MvdbBlock*)((uintptr_t)i & ~(uintptr_t)(LIST_BLOCK - 1));
+}
+
 static inline Iterator list_begin(const List *list)
 {
-    return list->first; 
+    return list->first == NULL ? NULL : list->first->values; 
 }
 
 static inline Iterator list_end(const List *list)
@@ -59,21 +158,26 @@ static inline Iterator list_end(const List *list)
 
 static inline Iterator iterator_next(const Iterator i)
 {
-    return i->next;
+    MvdbBlock* block = iterator_block(i);
+    
+    if (i + 1 < block->values + block->count)
+    {
+        return i + 1;
+    }
+    
+    return block->next == NULL ? NULL : block->next->values;
 }
 
 static inline Film* iterator_value(const Iterator i)
 {
-    return i->value;
+    return *i;
 }
 
 static inline Iterator iterator_set(Iterator i, Film* value)
 {
-    i-> value = value;
+    *i = value;
 }
 
-List * list;
-
 /*******************************************************************************
 
 Procedure   : list_populate
@@ -92,6 +196,25 @@ List* list_populate(FILE* input);
 
 /*******************************************************************************
 
+Procedure   : list_populateRejects
+
+Parameters  : FILE* input - a function that opens up, in read mode, an external 
+                            .txt file. Allowing the data to be scraped.
+              FILE* rejects - file that rows which are not valid films are 
+                              reported to, or NULL to drop them
+ 
+Returns     : List* - a pointer to a linked list of film structs
+ 
+Description : As list_populate, which reports rejected rows to stderr. Rows
+              are read by parser_next() (see parser.h), so quoted titles may
+              hold commas and quotes, and a row that is not a valid film is 
+              reported with its line number instead of being added.
+
+ ******************************************************************************/
+List* list_populateRejects(FILE* input, FILE* rejects);
+
+/*******************************************************************************
+
 Procedure   : list_new
 
 Parameters  : No parameters
@@ -105,6 +228,21 @@ List* list_new();
 
 /*******************************************************************************
 
+Procedure   : list_newTemporary
+
+Parameters  : void
+ 
+Returns     : List* - a pointer to an empty temporary list
+ 
+Description : As list_new, for a list that holds search results: films still
+              owned by another list. Its bytes are counted as results until
+              it is freed.
+
+ ******************************************************************************/
+List* list_newTemporary();
+
+/*******************************************************************************
+
 Procedure   : list_add
 
 Parameters  : List* list - a filled linked list of Film structs
@@ -135,6 +273,71 @@ void list_insert(List* list, Film* value);
 
 /*******************************************************************************
 
+Procedure   : list_find
+
+Parameters  : List* list - a filled linked list of Film structs
+              const char* title - title of the film
+              int year - year of the film
+ 
+Returns     : Film* - the film with that title and year, or NULL if none
+ 
+Description : Looks the film up in the list's index, building the index from
+              the list first if it does not have one yet.
+
+ ******************************************************************************/
+Film* list_find(List* list, const char* title, int year);
+
+/*******************************************************************************
+
+Procedure   : list_upsert
+
+Parameters  : List* list - a filled linked list of Film structs
+              Film* value - a filled Film Struct, owned by the list afterwards
+              ListUpsert mode - LIST_REPLACE or LIST_MERGE
+ 
+Returns     : int - 1 if value was added, 0 if it updated a film already held
+ 
+Description : Adds value to the end of the list unless a film with the same
+              title and year is already held. In that case the held film is
+              updated in place through its film_set methods, as set out by 
+              mode, and value is freed. Constant expected time.
+
+ ******************************************************************************/
+int list_upsert(List* list, Film* value, ListUpsert mode);
+
+/*******************************************************************************
+
+Procedure   : list_dedupe
+
+Parameters  : List* list - a filled linked list of Film structs
+              ListUpsert mode - LIST_REPLACE or LIST_MERGE
+ 
+Returns     : int - number of films removed
+ 
+Description : Single pass that keeps the first film of each title and year, 
+              folds every later film with the same key into it as 
+              list_upsert would, then unlinks and frees the later film. 
+              Leaves the list indexed.
+
+ ******************************************************************************/
+int list_dedupe(List* list, ListUpsert mode);
+
+/*******************************************************************************
+
+Procedure   : list_journal
+
+Parameters  : List* list - a filled linked list of Film structs
+ 
+Returns     : Journal* - the list's change journal
+ 
+Description : Returns the list's journal, creating it the first time and 
+              pointing every film already held at it.
+
+ ******************************************************************************/
+Journal* list_journal(List* list);
+
+/*******************************************************************************
+
 Procedure   : list_length
 
 Parameters  : List* list - a filled linked list of Film structs
@@ -183,7 +386,8 @@ Procedure   : list_sortBy
 Parameters  : List* list - a filled linked list of Film structs
               int* function(Mvdb*) - a function pointer to one a function that 
                                      instructs the function by what element it 
-                                     sorting by.
+                                     sorting by. It is passed each pair of 
+                                     neighbouring films in turn.
  
 Returns     : void
  
@@ -196,6 +400,39 @@ Description : Sorts the linked list, list, by a given element, as defined when
  ******************************************************************************/
 void list_sortBy(List* list, int function(Mvdb*));
 
+/*
+ * Sort keys known at compile time. Each entry gives the name of the key and
+ * the test that moves Film a after the Film b that follows it, in the same 
+ * direction as the matching comparator (list_year, list_lengthS, ...).
+ */
+#define LIST_SORT_KEYS(X)                                                      \
+    X(Year,         film_getYear(a) > film_getYear(b))                         \
+    X(Length,       film_getLength(a) < film_getLength(b))                     \
+    X(ReviewRating, film_getReviewRating(a) < film_getReviewRating(b))         \
+    X(Rating,       strcmp(film_getRating(a), film_getRating(b)) > 0)          \
+    X(Genre,        strcmp(film_getGenre(a), film_getGenre(b)) > 0)            \
+    X(Title,        strcmp(film_getTitle(a), film_getTitle(b)) > 0)
+
+/*******************************************************************************
+
+Procedure   : list_sortByYear, list_sortByLength, list_sortByReviewRating,
+              list_sortByRating, list_sortByGenre, list_sortByTitle
+
+Parameters  : List* list - a filled linked list of Film structs
+ 
+Returns     : void
+ 
+Description : One sort per entry in LIST_SORT_KEYS, generated at compile time.
+              Each gives the same order as list_sortBy with the matching
+              comparator, but the comparison is inlined into the sort loop 
+              and the current Film is kept in hand rather than fetched 
+              through the node again for every comparison.
+
+ ******************************************************************************/
+#define LIST_SORT_DECLARE(name, after) void list_sortBy##name(List* list);
+LIST_SORT_KEYS(LIST_SORT_DECLARE)
+#undef LIST_SORT_DECLARE
+
 /*******************************************************************************
 
 Procedure   : list_searchFilmNoir
@@ -207,7 +444,9 @@ Returns     : TempList* - pointer to a filled temporary holding linked list
 Description : Searched over the linked list, list, for all Film Struct's whose 
               Genre element contains "Film-Noir". When one is found it is added
               to a temporary holding linked list. That linked list is then 
-              returned and is ready for use.
+              returned and is ready for use, and must be freed with 
+              list_free when done with. list_findGenre finds the same films
+              without allocating.
 
  ******************************************************************************/
 List* list_searchFilmNoir(List* list);
@@ -223,13 +462,35 @@ Returns     : TempList* - pointer to a filled temporary holding linked list
 Description : Searched over the linked list, list, for all Film Struct's whose 
               Genre element contains "Sci-Fi". When one is found it is added
               to a temporary holding linked list. That linked list is then 
-              returned and is ready for use.
+              returned and is ready for use, and must be freed with 
+              list_free when done with. list_findGenre finds the same films
+              without allocating.
 
  ******************************************************************************/
 List* list_searchSciFi(List* list);
 
 /*******************************************************************************
 
+Procedure   : list_findGenre
+
+Parameters  : Iterator from - position to search from
+              const char* genre - genre the film must have
+               
+Returns     : Iterator - from, or the first position after it, whose film 
+                         has genre, or list_end() if there is none
+ 
+Description : Walks the list in place, so the films a list_search function 
+              would collect can be visited without building a list:
+
+                  for (Iterator i = list_findGenre(list_begin(list), genre);
+                          i != list_end(list);
+                          i = list_findGenre(iterator_next(i), genre))
+
+ ******************************************************************************/
+Iterator list_findGenre(Iterator from, const char* genre);
+
+/*******************************************************************************
+
 Procedure   : list_sortTitle
 
 Parameters  : List* list - a filled linked list of Film structs
@@ -263,13 +524,29 @@ Parameters  : List* list - a filled linked list of Film structs
  
 Returns     : void
  
-Description : Frees all the nodes in the linked list, list.
+Description : Frees all the nodes in the linked list, list, and its index.
+              The films are not freed and must still be valid, and the 
+              journal is kept, recording the clear.
 
  ******************************************************************************/
 void list_clear(List* list);
 
 /*******************************************************************************
 
+Procedure   : list_free
+
+Parameters  : List* list - a filled linked list of Film structs
+ 
+Returns     : void
+ 
+Description : Clears the list, then frees its journal and the list itself.
+              Anything still listening to the journal must have stopped.
+
+ ******************************************************************************/
+void list_free(List* list);
+
+/*******************************************************************************
+
 Procedure   : list_printAll
 
 Parameters  : List* list - a filled linked list of Film structs
@@ -295,12 +572,62 @@ Returns     : void
 Description : Iterates over the linked list - a set number of times, list, and 
               prints a selected Film Struct one by one by using the film_print()
               function. Also includes some general formatting for ease of use.
+              Prints "No such film" if the list has fewer than index films.
 
  ******************************************************************************/
 void list_printSelect(List* list, int index);
 
 /*******************************************************************************
 
+Procedure   : list_printSelectGenre
+
+Parameters  : List* list - a filled linked list of Film structs
+              const char* genre - genre the film must have
+              int index - which of the films with genre to print, from 1
+ 
+Returns     : void
+ 
+Description : Prints the same film as list_printSelect would print from the
+              list list_search made for genre, without making the list, or
+              "No such film" if fewer than index films have genre.
+
+ ******************************************************************************/
+void list_printSelectGenre(List* list, const char* genre, int index);
+
+/*******************************************************************************
+
+Procedure   : list_memory
+
+Parameters  : const List* list - a linked list of Film structs
+              ListMemory* memory - where to add the bytes held
+ 
+Returns     : void
+ 
+Description : Adds the bytes held by list, its films and its index to memory,
+              along with the bytes held by every temporary list. memory is 
+              added to rather than set, so it should start zeroed; indexes
+              kept outside the list can then be added to the same total.
+              Text shared by lazily loaded films is counted once for each 
+              run of films sharing it. Allocator overhead is not counted.
+
+ ******************************************************************************/
+void list_memory(const List* list, ListMemory* memory);
+
+/*******************************************************************************
+
+Procedure   : list_printMemory
+
+Parameters  : const ListMemory* memory - bytes from list_memory
+ 
+Returns     : void
+ 
+Description : Prints memory by category, in kilobytes, with its total.
+
+ ******************************************************************************/
+void list_printMemory(const ListMemory* memory);
+
+/*******************************************************************************
+
 Procedure   : list_title
 
 Parameters  : Mvdb* node - pointer to a Film Struct object
@@ -0,0 +1,146 @@
+/*
+ * File         : mvdb.c
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Source file that implements the shared helpers described in
+ *                mvdb.h.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - Shared top-k heap.
+ *                19/10/2026 v1.20 - mvdb_alignedAlloc.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "mvdb.h"
+
+void* mvdb_allocIn(size_t size, const char* caller)
+{
+    void* memory = calloc(1, size > 0 ? size : 1);
+
+    if (memory == NULL)
+    {
+        fprintf(stderr, "Error: Unable to allocate memory in %s()\n", caller);
+
+        exit(EXIT_FAILURE);
+    }
+
+    return memory;
+}
+
+void* mvdb_growIn(void* memory, size_t size, const char* caller)
+{
+    memory = realloc(memory, size > 0 ? size : 1);
+
+    if (memory == NULL)
+    {
+        fprintf(stderr, "Error: Unable to allocate memory in %s()\n", caller);
+
+        exit(EXIT_FAILURE);
+    }
+
+    return memory;
+}
+
+void* mvdb_alignedAllocIn(size_t alignment, size_t size, const char* caller)
+{
+    size = size > 0 ? (size + alignment - 1) & ~(alignment - 1) : alignment;
+
+    void* memory = aligned_alloc(alignment, size);
+
+    if (memory == NULL)
+    {
+        fprintf(stderr, "Error: Unable to allocate memory in %s()\n", caller);
+
+        exit(EXIT_FAILURE);
+    }
+
+    return memory;
+}
+
+double mvdb_now()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void mvdb_swap(char* a, char* b, size_t width)
+{
+    char temp[64];
+
+    while (width > 0)
+    {
+        size_t part = width < sizeof(temp) ? width : sizeof(temp);
+
+        memcpy(temp, a, part);
+        memcpy(a, b, part);
+        memcpy(b, temp, part);
+        a += part;
+        b += part;
+        width -= part;
+    }
+}
+
+void mvdb_heapUp(void* heap, int count, size_t width, MvdbOrder order)
+{
+    char* entries = (char*)heap;
+    int i = count - 1;
+
+    while (i > 0 && order(entries + i * width,
+            entries + (i - 1) / 2 * width) > 0)
+    {
+        mvdb_swap(entries + i * width, entries + (i - 1) / 2 * width, width);
+        i = (i - 1) / 2;
+    }
+}
+
+void mvdb_heapDown(void* heap, int count, size_t width, MvdbOrder order)
+{
+    char* entries = (char*)heap;
+    int i = 0;
+
+    for (;;)
+    {
+        int last = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+
+        if (left < count && order(entries + left * width,
+                entries + last * width) > 0)
+        {
+            last = left;
+        }
+        if (right < count && order(entries + right * width,
+                entries + last * width) > 0)
+        {
+            last = right;
+        }
+        if (last == i)
+        {
+            return;
+        }
+
+        mvdb_swap(entries + i * width, entries + last * width, width);
+        i = last;
+    }
+}
+
+void mvdb_heapSort(void* heap, int count, size_t width, MvdbOrder order)
+{
+    char* entries = (char*)heap;
+
+    /* Each last entry goes to the end, leaving the first at the start */
+    for (int end = count - 1; end > 0; end--)
+    {
+        mvdb_swap(entries, entries + end * width, width);
+        mvdb_heapDown(entries, end, width, order);
+    }
+}
@@ -0,0 +1,158 @@
+/*
+ * File         : mvdb.h
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Header file that defines the helpers every module of the
+ *                movie database shares: allocation that gives up with an
+ *                error naming the caller when memory runs out, and a
+ *                monotonic clock, and the binary heap the top-k searches
+ *                keep their best entries in.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - Shared top-k heap.
+ *                19/10/2026 v1.20 - mvdb_alignedAlloc.
+ */
+
+#ifndef MVDB_H
+#define MVDB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+/*
+ * The error names the function that asked for the memory, as each module's
+ * own allocator used to.
+ */
+#define mvdb_alloc(size) mvdb_allocIn((size), __func__)
+#define mvdb_grow(memory, size) mvdb_growIn((memory), (size), __func__)
+#define mvdb_alignedAlloc(alignment, size) \
+        mvdb_alignedAllocIn((alignment), (size), __func__)
+
+/*******************************************************************************
+
+Procedure   : mvdb_alloc
+
+Parameters  : size_t size - bytes wanted, which may be 0
+
+Returns     : void* - size bytes set to zero, never NULL
+
+Description : Prints "Error: Unable to allocate memory in <caller>()" and
+              exits if there is not enough memory. Must be freed with free().
+
+ ******************************************************************************/
+void* mvdb_allocIn(size_t size, const char* caller);
+
+/*******************************************************************************
+
+Procedure   : mvdb_grow
+
+Parameters  : void* memory - memory from mvdb_alloc or mvdb_grow, or NULL
+              size_t size - bytes wanted
+
+Returns     : void* - memory moved or resized to size bytes, never NULL
+
+Description : As realloc, exiting as mvdb_alloc does if it fails. Bytes past
+              the old size are not set.
+
+ ******************************************************************************/
+void* mvdb_growIn(void* memory, size_t size, const char* caller);
+
+/*******************************************************************************
+
+Procedure   : mvdb_alignedAlloc
+
+Parameters  : size_t alignment - a power of two the address must be a
+                                 multiple of
+              size_t size - bytes wanted, rounded up to a multiple of
+                            alignment
+
+Returns     : void* - size bytes at an aligned address, never NULL
+
+Description : As aligned_alloc, exiting as mvdb_alloc does if it fails. The
+              bytes are not set. Must be freed with free().
+
+ ******************************************************************************/
+void* mvdb_alignedAllocIn(size_t alignment, size_t size, const char* caller);
+
+/*******************************************************************************
+
+Procedure   : mvdb_now
+
+Parameters  : none
+
+Returns     : double - seconds on the monotonic clock
+
+Description : For timing; only differences between two calls mean anything.
+
+ ******************************************************************************/
+double mvdb_now();
+
+/*
+ * Order of the entries of a heap, as for qsort: negative if a comes before b.
+ * The heap keeps the entry that comes last at its root, so a top-k search
+ * can compare each candidate with the worst entry it has kept.
+ */
+typedef int (*MvdbOrder)(const void* a, const void* b);
+
+/*******************************************************************************
+
+Procedure   : mvdb_heapUp
+
+Parameters  : void* heap - count entries of width bytes, the first count - 1
+                           already a heap
+              int count - entries in heap
+              size_t width - bytes per entry
+              MvdbOrder order - order of the entries
+
+Returns     : void
+
+Description : Moves the entry just added at the end up to its place.
+
+ ******************************************************************************/
+void mvdb_heapUp(void* heap, int count, size_t width, MvdbOrder order);
+
+/*******************************************************************************
+
+Procedure   : mvdb_heapDown
+
+Parameters  : void* heap - count entries of width bytes, a heap but for the
+                           root
+              int count - entries in heap
+              size_t width - bytes per entry
+              MvdbOrder order - order of the entries
+
+Returns     : void
+
+Description : Moves a root that has just been replaced down to its place.
+
+ ******************************************************************************/
+void mvdb_heapDown(void* heap, int count, size_t width, MvdbOrder order);
+
+/*******************************************************************************
+
+Procedure   : mvdb_heapSort
+
+Parameters  : void* heap - count entries of width bytes, a heap
+              int count - entries in heap
+              size_t width - bytes per entry
+              MvdbOrder order - order of the entries
+
+Returns     : void
+
+Description : Sorts the heap in place by order, first entry first, in
+              O(count log count).
+
+ ******************************************************************************/
+void mvdb_heapSort(void* heap, int count, size_t width, MvdbOrder order);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MVDB_H */
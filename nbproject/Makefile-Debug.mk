@@ -35,9 +35,25 @@ OBJECTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}
 
 # Object Files
 OBJECTFILES= \
+	${OBJECTDIR}/catalogue.o \
 	${OBJECTDIR}/film.o \
+	${OBJECTDIR}/filmindex.o \
+	${OBJECTDIR}/groupby.o \
+	${OBJECTDIR}/journal.o \
+	${OBJECTDIR}/loader.o \
+	${OBJECTDIR}/loadgen.o \
 	${OBJECTDIR}/main.o \
-	${OBJECTDIR}/moviedatabase.o
+	${OBJECTDIR}/match.o \
+	${OBJECTDIR}/moviedatabase.o \
+	${OBJECTDIR}/mvdb.o \
+	${OBJECTDIR}/parser.o \
+	${OBJECTDIR}/pipeline.o \
+	${OBJECTDIR}/search.o \
+	${OBJECTDIR}/server.o \
+	${OBJECTDIR}/similar.o \
+	${OBJECTDIR}/sketch.o \
+	${OBJECTDIR}/stream.o \
+	${OBJECTDIR}/view.o
 
 
 # C Compiler Flags
@@ -54,7 +70,7 @@ FFLAGS=
 ASFLAGS=
 
 # Link Libraries and Options
-LDLIBSOPTIONS=
+LDLIBSOPTIONS=-lpthread -lm
 
 # Build Targets
 .build-conf: ${BUILD_SUBPROJECTS}
@@ -64,21 +80,101 @@ ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/c_coursework.exe: ${OBJECTFILES}
 	${MKDIR} -p ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}
 	${LINK.c} -o ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/c_coursework ${OBJECTFILES} ${LDLIBSOPTIONS}
 
+${OBJECTDIR}/catalogue.o: catalogue.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/catalogue.o catalogue.c
+
 ${OBJECTDIR}/film.o: film.c 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.c) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/film.o film.c
 
+${OBJECTDIR}/filmindex.o: filmindex.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/filmindex.o filmindex.c
+
+${OBJECTDIR}/groupby.o: groupby.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/groupby.o groupby.c
+
+${OBJECTDIR}/journal.o: journal.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/journal.o journal.c
+
+${OBJECTDIR}/loader.o: loader.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/loader.o loader.c
+
+${OBJECTDIR}/loadgen.o: loadgen.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/loadgen.o loadgen.c
+
 ${OBJECTDIR}/main.o: main.c 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.c) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/main.o main.c
 
+${OBJECTDIR}/match.o: match.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/match.o match.c
+
 ${OBJECTDIR}/moviedatabase.o: moviedatabase.c 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.c) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/moviedatabase.o moviedatabase.c
 
+${OBJECTDIR}/mvdb.o: mvdb.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/mvdb.o mvdb.c
+
+${OBJECTDIR}/parser.o: parser.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/parser.o parser.c
+
+${OBJECTDIR}/pipeline.o: pipeline.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/pipeline.o pipeline.c
+
+${OBJECTDIR}/search.o: search.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/search.o search.c
+
+${OBJECTDIR}/server.o: server.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/server.o server.c
+
+${OBJECTDIR}/similar.o: similar.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/similar.o similar.c
+
+${OBJECTDIR}/sketch.o: sketch.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/sketch.o sketch.c
+
+${OBJECTDIR}/stream.o: stream.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/stream.o stream.c
+
+${OBJECTDIR}/view.o: view.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.c) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/view.o view.c
+
 # Subprojects
 .build-subprojects:
 
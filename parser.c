@@ -0,0 +1,862 @@
+/*
+ * File         : parser.c
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Source file that implements the validating films.txt reader
+ *                described in parser.h.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - parser_feed and parser_complete.
+ *                19/10/2026 v1.20 - list_populateLazy, film_decode and
+ *                                   film_release.
+ *                19/10/2026 v1.30 - Joined lines that do not parse are cut
+ *                                   back to their first line.
+ *                19/10/2026 v1.40 - Memory allocated through mvdb.h.
+ *                19/10/2026 v1.50 - Lines read ahead for an open quote are
+ *                                   scanned and moved once.
+ *                19/10/2026 v1.60 - Decimals may carry an exponent, as
+ *                                   film_write can write one.
+ *                19/10/2026 v1.70 - film_measure.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "parser.h"
+#include "mvdb.h"
+
+#define PARSER_FIELDS 6
+
+typedef struct _ParserField
+{
+    char* start;
+    size_t length;
+    int escaped;
+}ParserField;
+
+static const char* parser_names[PARSER_FIELDS] =
+{
+    "title", "year", "certificate", "genre", "run time", "review rating"
+};
+
+void parser_init(Parser* parser, FILE* input, FILE* rejects)
+{
+    memset(parser, 0, sizeof(Parser));
+    parser->input = input;
+    parser->rejects = rejects;
+}
+
+void parser_free(Parser* parser)
+{
+    free(parser->buffer);
+    free(parser->next);
+    parser->buffer = parser->next = NULL;
+    parser->size = parser->nextSize = 0;
+    parser->bufferAt = parser->bufferLength = 0;
+}
+
+/*
+ * Whole number made only of digits with an optional leading minus.
+ */
+static int parser_integer(const ParserField* field, int* value)
+{
+    const char* p = field->start;
+    const char* end = p + field->length;
+    int negative = p < end && *p == '-';
+    long result = 0;
+
+    p += negative;
+
+    if (p == end || end - p > 9)
+    {
+        return 0;
+    }
+
+    for (; p < end; p++)
+    {
+        if (*p < '0' || *p > '9')
+        {
+            return 0;
+        }
+
+        result = result * 10 + (*p - '0');
+    }
+
+    *value = (int)(negative ? -result : result);
+
+    return 1;
+}
+
+/*
+ * Decimal number such as 8.3: digits, then optionally a point and more
+ * digits, then optionally an exponent such as e-05. Built from integer
+ * digits, so no locale or strtod is involved.
+ */
+static int parser_decimal(const ParserField* field, float* value)
+{
+    const char* p = field->start;
+    const char* end = p + field->length;
+    int negative = p < end && *p == '-';
+    double whole = 0;
+    double scale = 1;
+    int digits = 0;
+
+    p += negative;
+
+    for (; p < end && *p >= '0' && *p <= '9'; p++, digits++)
+    {
+        whole = whole * 10 + (*p - '0');
+    }
+
+    if (p < end && *p == '.')
+    {
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++, digits++)
+        {
+            whole = whole * 10 + (*p - '0');
+            scale *= 10;
+        }
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E') && digits > 0)
+    {
+        int minus = ++p < end && *p == '-';
+        int exponent = 0;
+        int exponentDigits = 0;
+
+        p += p < end && (*p == '-' || *p == '+');
+
+        for (; p < end && *p >= '0' && *p <= '9' && exponentDigits < 3;
+                p++, exponentDigits++)
+        {
+            exponent = exponent * 10 + (*p - '0');
+        }
+
+        if (exponentDigits == 0)
+        {
+            return 0;
+        }
+
+        for (; exponent > 0; exponent--)
+        {
+            if (minus)
+            {
+                scale *= 10;
+            }
+            else
+            {
+                whole *= 10;
+            }
+        }
+    }
+
+    if (p != end || digits == 0 || digits > 15)
+    {
+        return 0;
+    }
+
+    *value = (float)((negative ? -whole : whole) / scale);
+
+    return 1;
+}
+
+/*
+ * Turns doubled quotes back into single quotes and null terminates the field
+ * in place. The terminator lands on the closing quote or separator.
+ */
+static char* parser_finish(ParserField* field)
+{
+    if (field->escaped)
+    {
+        char* read = field->start;
+        char* write = field->start;
+        char* end = field->start + field->length;
+
+        while (read < end)
+        {
+            if (*read == '"')
+            {
+                read++;
+            }
+
+            *write++ = *read++;
+        }
+
+        field->length = write - field->start;
+    }
+
+    field->start[field->length] = '\0';
+
+    return field->start;
+}
+
+/*
+ * Checks a record and finds its fields, without changing it.
+ */
+static int parser_check(const char* text, size_t length,
+        ParserField* fields, FilmRecord* record, char* error, size_t errorSize)
+{
+    char* end = (char*)text + length;
+    char* p = (char*)text;
+    int count = 0;
+
+    while (end > text && (end[-1] == '\n' || end[-1] == '\r'))
+    {
+        end--;
+    }
+
+    for (;;)
+    {
+        if (count == PARSER_FIELDS)
+        {
+            snprintf(error, errorSize, "more than %d fields", PARSER_FIELDS);
+            return 0;
+        }
+
+        ParserField* field = &fields[count++];
+        field->escaped = 0;
+
+        if (p < end && *p == '"')
+        {
+            char* quote = p + 1;
+
+            field->start = quote;
+
+            for (;;)
+            {
+                quote = (char*)memchr(quote, '"', end - quote);
+
+                if (quote == NULL)
+                {
+                    snprintf(error, errorSize, "%s: unterminated quoted field",
+                            parser_names[count - 1]);
+                    return 0;
+                }
+                if (quote + 1 < end && quote[1] == '"')
+                {
+                    field->escaped = 1;
+                    quote += 2;
+                    continue;
+                }
+
+                break;
+            }
+
+            field->length = quote - field->start;
+            p = quote + 1;
+
+            if (p < end && *p != ',')
+            {
+                snprintf(error, errorSize, "%s: text after closing quote",
+                        parser_names[count - 1]);
+                return 0;
+            }
+        }
+        else
+        {
+            char* comma = (char*)memchr(p, ',', end - p);
+
+            if (comma == NULL)
+            {
+                comma = end;
+            }
+            if (memchr(p, '"', comma - p) != NULL)
+            {
+                snprintf(error, errorSize, "%s: quote inside unquoted field",
+                        parser_names[count - 1]);
+                return 0;
+            }
+
+            field->start = p;
+            field->length = comma - p;
+            p = comma;
+        }
+
+        if (p == end)
+        {
+            break;
+        }
+
+        p++;
+    }
+
+    if (count != PARSER_FIELDS)
+    {
+        snprintf(error, errorSize, "expected %d fields, found %d",
+                PARSER_FIELDS, count);
+        return 0;
+    }
+
+    if (fields[0].length == 0)
+    {
+        snprintf(error, errorSize, "title: empty");
+        return 0;
+    }
+    if (!parser_integer(&fields[1], &record->year))
+    {
+        snprintf(error, errorSize, "year: '%.*s' is not a whole number",
+                (int)(fields[1].length < 20 ? fields[1].length : 20),
+                fields[1].start);
+        return 0;
+    }
+    if (fields[2].length > PARSER_MAX_RATING)
+    {
+        snprintf(error, errorSize, "certificate: longer than %d characters",
+                (int)PARSER_MAX_RATING);
+        return 0;
+    }
+    if (fields[3].length > PARSER_MAX_GENRE)
+    {
+        snprintf(error, errorSize, "genre: longer than %d characters",
+                (int)PARSER_MAX_GENRE);
+        return 0;
+    }
+    if (!parser_integer(&fields[4], &record->length) || record->length < 0)
+    {
+        snprintf(error, errorSize, "run time: '%.*s' is not a whole number",
+                (int)(fields[4].length < 20 ? fields[4].length : 20),
+                fields[4].start);
+        return 0;
+    }
+    if (!parser_decimal(&fields[5], &record->reviewRating))
+    {
+        snprintf(error, errorSize, "review rating: '%.*s' is not a number",
+                (int)(fields[5].length < 20 ? fields[5].length : 20),
+                fields[5].start);
+        return 0;
+    }
+
+    return 1;
+}
+
+int parser_parse(char* text, size_t length, FilmRecord* record, char* error,
+        size_t errorSize)
+{
+    ParserField fields[PARSER_FIELDS];
+
+    if (!parser_check(text, length, fields, record, error, errorSize))
+    {
+        return 0;
+    }
+
+    /* Everything checked, so the record can now be changed in place */
+    record->title = parser_finish(&fields[0]);
+    record->rating = parser_finish(&fields[2]);
+    record->genre = parser_finish(&fields[3]);
+
+    return 1;
+}
+
+/*
+ * Flips the open quote state for every quote in a chunk of text. Doubled
+ * quotes flip it twice, so only a real opening or closing quote counts.
+ */
+static int parser_quotes(const char* text, size_t length, int open)
+{
+    const char* end = text + length;
+
+    while ((text = (const char*)memchr(text, '"', end - text)) != NULL)
+    {
+        open = !open;
+        text++;
+    }
+
+    return open;
+}
+
+static int parser_blank(const char* text, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        if (text[i] != '\n' && text[i] != '\r' && text[i] != ' '
+                && text[i] != '\t')
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static void parser_reject(Parser* parser, long line, const char* text,
+        size_t length)
+{
+    parser->rejected++;
+
+    if (parser->rejects == NULL)
+    {
+        return;
+    }
+
+    fprintf(parser->rejects, "line %ld: %s\n", line, parser->error);
+    fwrite(text, 1, length, parser->rejects);
+
+    if (length == 0 || text[length - 1] != '\n')
+    {
+        fputc('\n', parser->rejects);
+    }
+}
+
+void parser_feed(Parser* parser, char* text, size_t length)
+{
+    parser->text = text;
+    parser->textLength = length;
+    parser->textAt = 0;
+}
+
+/*
+ * Length of the line at the start of text, its line break included.
+ */
+static size_t parser_line(const char* text, size_t length)
+{
+    const char* end = (const char*)memchr(text, '\n', length);
+
+    return end == NULL ? length : (size_t)(end - text) + 1;
+}
+
+/*
+ * Length of the record at the start of text, and in *lines the number of
+ * lines it spans. A quoted field carries on over line breaks, up to
+ * PARSER_MAX_RECORD, but joined lines that do not make a valid record are
+ * taken to be a stray quote: the record is then only the first line, and the
+ * next starts on the line after it, so the quote costs one row rather than
+ * every row after it. Returns 0 if the quote is still open at the end of
+ * text and more might follow (final is 0); scan then holds how far the
+ * record was scanned, and the next call with the same record, and more text
+ * after it, carries on from there. scan is cleared once a record is cut.
+ */
+static size_t parser_record(const char* text, size_t length, int final,
+        ParserScan* scan, long* lines)
+{
+    size_t record;
+
+    if (scan->lines == 0)
+    {
+        scan->first = parser_line(text, length);
+        scan->length = scan->first;
+        scan->open = parser_quotes(text, scan->first, 0);
+        scan->lines = 1;
+    }
+
+    while (scan->open && scan->length < PARSER_MAX_RECORD
+            && scan->length < length)
+    {
+        size_t more = parser_line(text + scan->length,
+                length - scan->length);
+
+        scan->open = parser_quotes(text + scan->length, more, scan->open);
+        scan->length += more;
+        scan->lines++;
+    }
+
+    if (scan->open && !final && scan->length < PARSER_MAX_RECORD)
+    {
+        return 0;
+    }
+
+    record = scan->length;
+    *lines = scan->lines;
+
+    if (scan->lines > 1)
+    {
+        ParserField fields[PARSER_FIELDS];
+        FilmRecord check;
+        char error[128];
+
+        if (!parser_check(text, record, fields, &check, error, sizeof(error)))
+        {
+            record = scan->first;
+            *lines = 1;
+        }
+    }
+
+    memset(scan, 0, sizeof(ParserScan));
+
+    return record;
+}
+
+size_t parser_complete(const char* text, size_t length)
+{
+    size_t at = 0;
+    ParserScan scan = { 0 };
+    long lines;
+
+    /* Only whole lines can be cut, so the last unfinished line is left out */
+    while (length > 0 && text[length - 1] != '\n')
+    {
+        length--;
+    }
+
+    while (at < length)
+    {
+        size_t record = parser_record(text + at, length - at, 0, &scan,
+                &lines);
+
+        if (record == 0)
+        {
+            break;
+        }
+
+        at += record;
+    }
+
+    return at;
+}
+
+/*
+ * Reads the next valid record from text, starting at *at and moving it on
+ * past every record read or rejected. final says text holds all that is left
+ * of the input; if not, returns 0 without moving *at when the next record
+ * might run on past length.
+ */
+static int parser_take(Parser* parser, char* text, size_t* at, size_t length,
+        int final, FilmRecord* record)
+{
+    while (*at < length)
+    {
+        char* start = text + *at;
+        long lines;
+        size_t size = parser_record(start, length - *at, final,
+                &parser->scan, &lines);
+        long first = parser->line + 1;
+
+        if (size == 0)
+        {
+            return 0;
+        }
+
+        *at += size;
+        parser->line += lines;
+
+        if (parser_blank(start, size))
+        {
+            continue;
+        }
+
+        if (parser_parse(start, size, record, parser->error,
+                sizeof(parser->error)))
+        {
+            record->line = first;
+            parser->records++;
+
+            return 1;
+        }
+
+        parser_reject(parser, first, start, size);
+    }
+
+    return 0;
+}
+
+/*
+ * Appends the next line of the input to the buffer, first moving what is
+ * left of the buffer to its start if it is not there already, so a record
+ * read ahead over many lines is moved once. Returns 0 at the end of the
+ * input.
+ */
+static int parser_fill(Parser* parser)
+{
+    size_t left = parser->bufferLength - parser->bufferAt;
+
+    /* Usually nothing is left, so the line can be read straight in */
+    ssize_t got = left == 0
+            ? getline(&parser->buffer, &parser->size, parser->input)
+            : getline(&parser->next, &parser->nextSize, parser->input);
+
+    if (got <= 0)
+    {
+        parser->eof = 1;
+
+        return 0;
+    }
+
+    if (left == 0)
+    {
+        parser->bufferAt = 0;
+        parser->bufferLength = got;
+
+        return 1;
+    }
+
+    if (parser->bufferAt > 0)
+    {
+        memmove(parser->buffer, parser->buffer + parser->bufferAt, left);
+        parser->bufferAt = 0;
+        parser->bufferLength = left;
+    }
+
+    if (left + got + 1 > parser->size)
+    {
+        size_t size = parser->size * 2;
+
+        while (size < left + got + 1)
+        {
+            size *= 2;
+        }
+
+        parser->buffer = (char*)mvdb_grow(parser->buffer, size);
+        parser->size = size;
+    }
+
+    memcpy(parser->buffer + left, parser->next, got + 1);
+    parser->bufferLength = left + got;
+
+    return 1;
+}
+
+int parser_next(Parser* parser, FilmRecord* record)
+{
+    if (parser->input == NULL)
+    {
+        return parser_take(parser, parser->text, &parser->textAt,
+                parser->textLength, 1, record);
+    }
+
+    /* Lines are read ahead only while a quote is open */
+    for (;;)
+    {
+        if (parser_take(parser, parser->buffer, &parser->bufferAt,
+                parser->bufferLength, parser->eof, record))
+        {
+            return 1;
+        }
+
+        if (parser->eof)
+        {
+            return 0;
+        }
+
+        parser_fill(parser);
+    }
+}
+
+Film* film_fromRecord(const FilmRecord* record)
+{
+    return film_new(record->title, record->year, record->rating,
+            record->genre, record->length, record->reviewRating);
+}
+
+/*
+ * Finds field number index of a record without changing it. Returns 0 if
+ * the record has fewer fields or a quote is never closed.
+ */
+static int parser_locate(const char* record, int index, ParserField* field)
+{
+    const char* p = record;
+
+    for (int i = 0; ; i++)
+    {
+        const char* start = p;
+        size_t length;
+        int escaped = 0;
+
+        if (*p == '"')
+        {
+            const char* quote = ++start;
+
+            for (;;)
+            {
+                quote = strchr(quote, '"');
+
+                if (quote == NULL)
+                {
+                    return 0;
+                }
+                if (quote[1] == '"')
+                {
+                    escaped = 1;
+                    quote += 2;
+                    continue;
+                }
+
+                break;
+            }
+
+            length = quote - start;
+            p = quote + 1;
+        }
+        else
+        {
+            length = strcspn(p, ",\r\n");
+            p += length;
+        }
+
+        if (i == index)
+        {
+            field->start = (char*)start;
+            field->length = length;
+            field->escaped = escaped;
+
+            return 1;
+        }
+
+        if (*p != ',')
+        {
+            return 0;
+        }
+
+        p++;
+    }
+}
+
+/*
+ * Copies a located field into buffer, turning doubled quotes back into single
+ * quotes and cutting it to fit.
+ */
+static void parser_copy(const ParserField* field, char* buffer, size_t size)
+{
+    const char* read = field->start;
+    const char* end = field->start + field->length;
+    char* write = buffer;
+
+    while (read < end && write < buffer + size - 1)
+    {
+        if (field->escaped && *read == '"')
+        {
+            read++;
+        }
+
+        *write++ = *read++;
+    }
+
+    *write = '\0';
+}
+
+void film_decode(Film* film, FilmField field)
+{
+    char none = '\0';
+    ParserField found = { &none, 0, 0 };
+
+    parser_locate(film->record, (int)field, &found);
+    film->decoded |= 1u << field;
+
+    switch (field)
+    {
+        case FILM_TITLE:
+            film->title = (char*)mvdb_alloc(found.length + 1);
+
+            parser_copy(&found, film->title, found.length + 1);
+            break;
+
+        case FILM_YEAR:
+            if (!parser_integer(&found, &film->year))
+            {
+                film->year = 0;
+            }
+            break;
+
+        case FILM_RATING:
+            parser_copy(&found, film->rating, sizeof(film->rating));
+            break;
+
+        case FILM_GENRE:
+            parser_copy(&found, film->genre, sizeof(film->genre));
+            break;
+
+        case FILM_LENGTH:
+            if (!parser_integer(&found, &film->length))
+            {
+                film->length = 0;
+            }
+            break;
+
+        case FILM_REVIEWRATING:
+            if (!parser_decimal(&found, &film->reviewRating))
+            {
+                film->reviewRating = 0;
+            }
+            break;
+    }
+}
+
+size_t film_measure(const Film* film, FilmField field)
+{
+    char none = '\0';
+    ParserField found = { &none, 0, 0 };
+    size_t length = 0;
+
+    parser_locate(film->record, (int)field, &found);
+
+    for (size_t i = 0; i < found.length; i++, length++)
+    {
+        i += found.escaped && found.start[i] == '"';
+    }
+
+    return length;
+}
+
+void film_release(Film* film)
+{
+    if (--film->text->films == 0)
+    {
+        free(film->text->data);
+        free(film->text);
+    }
+
+    film->text = NULL;
+}
+
+static FilmText* parser_slurp(FILE* input, size_t* length)
+{
+    FilmText* text = (FilmText*)mvdb_alloc(sizeof(FilmText));
+    size_t size = 1 << 20;
+    size_t got;
+
+    *length = 0;
+    text->data = (char*)mvdb_alloc(size);
+
+    while ((got = fread(text->data + *length, 1, size - *length - 1, input))
+            > 0)
+    {
+        *length += got;
+
+        if (size - *length - 1 == 0)
+        {
+            size *= 2;
+            text->data = (char*)mvdb_grow(text->data, size);
+        }
+    }
+
+    text->data[*length] = '\0';
+    text->size = size;
+
+    return text;
+}
+
+List* list_populateLazy(FILE* input)
+{
+    size_t length;
+    FilmText* text = parser_slurp(input, &length);
+    List* list = list_new();
+    size_t at = 0;
+    ParserScan scan = { 0 };
+
+    while (at < length)
+    {
+        char* start = text->data + at;
+        long lines;
+
+        /* Records are cut exactly as parser_next cuts them */
+        size_t line = parser_record(start, length - at, 1, &scan, &lines);
+
+        at += line;
+
+        if (!parser_blank(start, line))
+        {
+            list_add(list, film_newLazy(text, start));
+        }
+    }
+
+    printf("Films successfully read into MVDB: %i", list_length(list));
+
+    if (text->films == 0)
+    {
+        free(text->data);
+        free(text);
+    }
+
+    return list;
+}
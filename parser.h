@@ -0,0 +1,246 @@
+/*
+ * File         : parser.h
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Header file that defines a validating reader for films.txt.
+ *                Records follow RFC 4180: fields may be quoted, quoted fields
+ *                may hold commas, doubled quotes and line breaks, and lines
+ *                may be of any length. Rows that do not hold a valid film are
+ *                skipped and reported, with their line number, to a reject
+ *                file instead of being turned into a half filled Film.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - Records can be read from memory as well as
+ *                                   from a file, for the pipelined loader.
+ *                19/10/2026 v1.20 - list_populateLazy.
+ *                19/10/2026 v1.30 - A stray quote costs only its own row.
+ *                19/10/2026 v1.40 - Lines read ahead for an open quote are
+ *                                   scanned once.
+ */
+
+#ifndef PARSER_H
+#define PARSER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+
+#include "film.h"
+#include "moviedatabase.h"
+
+/*
+ * Longest record, in bytes, that may be spread over several lines by an open
+ * quote before it is given up as unterminated.
+ */
+#define PARSER_MAX_RECORD (1 << 20)
+
+/*
+ * Longest certificate and genre that fit in a Film struct.
+ */
+#define PARSER_MAX_RATING (sizeof(((Film*)0)->rating) - 1)
+#define PARSER_MAX_GENRE  (sizeof(((Film*)0)->genre) - 1)
+
+/*
+ * One parsed row. The strings point into the parser's buffer and are only
+ * valid until the next call to parser_next.
+ */
+typedef struct _FilmRecord
+{
+    char* title;
+    int year;
+    char* rating;
+    char* genre;
+    int length;
+    float reviewRating;
+    long line;
+}FilmRecord;
+
+/*
+ * How far a record with an open quote has been scanned: the length of its
+ * first line, the lines and bytes scanned so far, and whether the quote is
+ * still open after them. Kept between reads so each line read ahead is
+ * scanned once, however many follow it.
+ */
+typedef struct _ParserScan
+{
+    size_t first;
+    size_t length;
+    long lines;
+    int open;
+}ParserScan;
+
+/*
+ * Reads from input, or from text when input is NULL (see parser_feed).
+ */
+typedef struct _Parser
+{
+    FILE* input;
+    FILE* rejects;
+    char* buffer;
+    size_t size;
+    size_t bufferAt;
+    size_t bufferLength;
+    ParserScan scan;
+    int eof;
+    char* next;
+    size_t nextSize;
+    char* text;
+    size_t textLength;
+    size_t textAt;
+    long line;
+    long records;
+    long rejected;
+    char error[128];
+}Parser;
+
+/*******************************************************************************
+
+Procedure   : parser_init
+
+Parameters  : Parser* parser - parser to set up
+              FILE* input - an open films.txt style file, or NULL if the 
+                            records will be given by parser_feed
+              FILE* rejects - file that rejected rows are written to, or NULL
+                              to drop them silently
+
+Returns     : void
+
+Description : Prepares a parser to read records from input.
+
+ ******************************************************************************/
+void parser_init(Parser* parser, FILE* input, FILE* rejects);
+
+/*******************************************************************************
+
+Procedure   : parser_next
+
+Parameters  : Parser* parser - parser set up by parser_init
+              FilmRecord* record - filled in with the next valid row
+
+Returns     : int - 1 if a record was read, 0 at the end of the input
+
+Description : Reads the next record, joining lines while a quoted field is
+              still open. If the joined lines do not make a valid record,
+              the quote is taken to be a stray one: only the first line is
+              rejected, and reading carries on from the line after it.
+              Blank lines are skipped. Invalid rows are written to the
+              reject file as "line <n>: <error>" followed by the row itself,
+              counted in parser->rejected and skipped.
+
+ ******************************************************************************/
+int parser_next(Parser* parser, FilmRecord* record);
+
+/*******************************************************************************
+
+Procedure   : parser_feed
+
+Parameters  : Parser* parser - parser set up by parser_init with no input
+              char* text - whole records, which are unescaped in place
+              size_t length - number of bytes in text
+
+Returns     : void
+
+Description : Gives a parser the next piece of a films.txt style file held in
+              memory. parser_next then reads records from it until it runs 
+              out and returns 0. Line numbers and counts carry on from the
+              previous piece, so a file can be fed through in blocks cut by
+              parser_complete.
+
+ ******************************************************************************/
+void parser_feed(Parser* parser, char* text, size_t length);
+
+/*******************************************************************************
+
+Procedure   : parser_complete
+
+Parameters  : const char* text - the start of a films.txt style file, or of
+                                 a piece of one that starts on a record
+              size_t length - number of bytes in text
+
+Returns     : size_t - number of bytes at the start of text that hold whole
+                       records
+
+Description : Finds the end of the last whole record, cutting records the
+              same way parser_next does, so text can be cut into blocks
+              without splitting a record.
+
+ ******************************************************************************/
+size_t parser_complete(const char* text, size_t length);
+
+/*******************************************************************************
+
+Procedure   : parser_parse
+
+Parameters  : char* text - one record, which is unescaped in place
+              size_t length - number of bytes in text, a trailing line break
+                              included or not
+              FilmRecord* record - filled in when the record is valid
+              char* error - message describing the problem when it is not
+              size_t errorSize - number of bytes available in error
+
+Returns     : int - 1 if the record holds a valid film, 0 if not
+
+Description : Single pass over one record. Field boundaries are found and
+              every field is checked before anything is written, so a
+              rejected record is left exactly as it was read.
+
+ ******************************************************************************/
+int parser_parse(char* text, size_t length, FilmRecord* record, char* error,
+        size_t errorSize);
+
+/*******************************************************************************
+
+Procedure   : parser_free
+
+Parameters  : Parser* parser - parser set up by parser_init
+
+Returns     : void
+
+Description : Frees the parser's buffers. Does not close its files.
+
+ ******************************************************************************/
+void parser_free(Parser* parser);
+
+/*******************************************************************************
+
+Procedure   : film_fromRecord
+
+Parameters  : const FilmRecord* record - a row read by parser_next
+
+Returns     : Film* - pointer to a newly created film struct
+
+Description : Uses film_new() to copy a parsed row into a new Film Struct.
+
+ ******************************************************************************/
+Film* film_fromRecord(const FilmRecord* record);
+
+/*******************************************************************************
+
+Procedure   : list_populateLazy
+
+Parameters  : FILE* input - an open films.txt style file
+ 
+Returns     : List* - a pointer to a linked list of film structs
+ 
+Description : Reads the whole file into memory and only finds where each 
+              record starts, cutting records as parser_next does. Each field
+              of a film is decoded from its record the first time a 
+              film_get method asks for it and kept from then on, so a query
+              that reads one or two fields of each film never parses the 
+              rest. Rows are not checked: a field that cannot be read is 
+              left empty or zero, so the file should be one known to be
+              valid, such as one written by film_write.
+
+ ******************************************************************************/
+List* list_populateLazy(FILE* input);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PARSER_H */
@@ -0,0 +1,343 @@
+/*
+ * File         : pipeline.c
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Source file that implements the lazy queries described in
+ *                pipeline.h.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - Memory allocated through mvdb.h.
+ *                19/10/2026 v1.20 - Top-k kept in the heap of mvdb.h.
+ *                19/10/2026 v1.30 - Filter strings copied whole.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pipeline.h"
+#include "mvdb.h"
+
+static Pipe* pipe_new(Pipe* from, int (*pull)(Pipe*, PipeRow*))
+{
+    Pipe* pipe = (Pipe*)mvdb_alloc(sizeof(Pipe));
+
+    pipe->from = from;
+    pipe->pull = pull;
+
+    return pipe;
+}
+
+static int pipe_pullSource(Pipe* pipe, PipeRow* row)
+{
+    if (pipe->at == list_end(pipe->list))
+    {
+        return 0;
+    }
+
+    row->film = iterator_value(pipe->at);
+    row->text = NULL;
+    row->number = 0;
+    pipe->at = iterator_next(pipe->at);
+    pipe->read++;
+
+    return 1;
+}
+
+Pipe* pipe_from(const List* list)
+{
+    Pipe* pipe = pipe_new(NULL, pipe_pullSource);
+
+    pipe->list = list;
+    pipe->at = list_begin(list);
+
+    return pipe;
+}
+
+static int pipe_pullFilter(Pipe* pipe, PipeRow* row)
+{
+    while (pipe->from->pull(pipe->from, row))
+    {
+        if (pipe->test(row->film, pipe->argument))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+Pipe* pipe_filter(Pipe* from, PipeTest test, const void* argument)
+{
+    Pipe* pipe = pipe_new(from, pipe_pullFilter);
+
+    pipe->test = test;
+    pipe->argument = argument;
+
+    return pipe;
+}
+
+/*
+ * The named filters keep their argument in their own stage, which is passed
+ * to the test as argument.
+ */
+static int pipe_testGenre(const Film* film, const void* argument)
+{
+    return film_hasGenre(film, ((const Pipe*)argument)->text);
+}
+
+static int pipe_testRating(const Film* film, const void* argument)
+{
+    return film_hasRating(film, ((const Pipe*)argument)->text);
+}
+
+static int pipe_testYears(const Film* film, const void* argument)
+{
+    const Pipe* pipe = (const Pipe*)argument;
+    int year = film_getYear(film);
+
+    return year >= pipe->low && year <= pipe->high;
+}
+
+Pipe* pipe_genre(Pipe* from, const char* genre)
+{
+    Pipe* pipe = pipe_filter(from, pipe_testGenre, NULL);
+
+    pipe->argument = pipe;
+    pipe->text = strdup(genre);
+
+    return pipe;
+}
+
+Pipe* pipe_rating(Pipe* from, const char* rating)
+{
+    Pipe* pipe = pipe_filter(from, pipe_testRating, NULL);
+
+    pipe->argument = pipe;
+    pipe->text = strdup(rating);
+
+    return pipe;
+}
+
+Pipe* pipe_years(Pipe* from, int low, int high)
+{
+    Pipe* pipe = pipe_filter(from, pipe_testYears, NULL);
+
+    pipe->argument = pipe;
+    pipe->low = low;
+    pipe->high = high;
+
+    return pipe;
+}
+
+static int pipe_pullProject(Pipe* pipe, PipeRow* row)
+{
+    if (!pipe->from->pull(pipe->from, row))
+    {
+        return 0;
+    }
+
+    row->text = NULL;
+    row->number = 0;
+
+    switch (pipe->field)
+    {
+        case FILM_TITLE:
+            row->text = film_getTitle(row->film);
+            break;
+
+        case FILM_YEAR:
+            row->number = film_getYear(row->film);
+            break;
+
+        case FILM_RATING:
+            row->text = film_getRating(row->film);
+            break;
+
+        case FILM_GENRE:
+            row->text = film_getGenre(row->film);
+            break;
+
+        case FILM_LENGTH:
+            row->number = film_getLength(row->film);
+            break;
+
+        case FILM_REVIEWRATING:
+            row->number = film_getReviewRating(row->film);
+            break;
+    }
+
+    return 1;
+}
+
+Pipe* pipe_project(Pipe* from, FilmField field)
+{
+    Pipe* pipe = pipe_new(from, pipe_pullProject);
+
+    pipe->field = field;
+
+    return pipe;
+}
+
+static int pipe_pullSkip(Pipe* pipe, PipeRow* row)
+{
+    for (; pipe->seen < pipe->count; pipe->seen++)
+    {
+        if (!pipe->from->pull(pipe->from, row))
+        {
+            return 0;
+        }
+    }
+
+    return pipe->from->pull(pipe->from, row);
+}
+
+static int pipe_pullLimit(Pipe* pipe, PipeRow* row)
+{
+    if (pipe->seen >= pipe->count || !pipe->from->pull(pipe->from, row))
+    {
+        return 0;
+    }
+
+    pipe->seen++;
+
+    return 1;
+}
+
+Pipe* pipe_skip(Pipe* from, long count)
+{
+    Pipe* pipe = pipe_new(from, pipe_pullSkip);
+
+    pipe->count = count;
+
+    return pipe;
+}
+
+Pipe* pipe_limit(Pipe* from, long count)
+{
+    Pipe* pipe = pipe_new(from, pipe_pullLimit);
+
+    pipe->count = count;
+
+    return pipe;
+}
+
+static double pipe_key(const Film* film, FilmField field)
+{
+    switch (field)
+    {
+        case FILM_YEAR:
+            return film_getYear(film);
+
+        case FILM_LENGTH:
+            return film_getLength(film);
+
+        case FILM_REVIEWRATING:
+            return film_getReviewRating(film);
+
+        default:
+            return 0;
+    }
+}
+
+/*
+ * Highest key first, and of equal keys the one read first.
+ */
+static int pipe_byKey(const void* a, const void* b)
+{
+    const PipeRanked* x = (const PipeRanked*)a;
+    const PipeRanked* y = (const PipeRanked*)b;
+
+    if (x->key != y->key)
+    {
+        return x->key > y->key ? -1 : 1;
+    }
+
+    return x->seq < y->seq ? -1 : x->seq > y->seq;
+}
+
+static void pipe_drain(Pipe* pipe)
+{
+    PipeRanked entry;
+
+    while (pipe->from->pull(pipe->from, &entry.row))
+    {
+        entry.key = pipe_key(entry.row.film, pipe->field);
+        entry.seq = pipe->seen++;
+
+        if (pipe->size < pipe->count)
+        {
+            pipe->ranked[pipe->size++] = entry;
+            mvdb_heapUp(pipe->ranked, pipe->size, sizeof(PipeRanked),
+                    pipe_byKey);
+        }
+        else if (pipe->size > 0 && entry.key > pipe->ranked[0].key)
+        {
+            pipe->ranked[0] = entry;
+            mvdb_heapDown(pipe->ranked, pipe->size, sizeof(PipeRanked),
+                    pipe_byKey);
+        }
+    }
+
+    mvdb_heapSort(pipe->ranked, pipe->size, sizeof(PipeRanked), pipe_byKey);
+    pipe->drained = 1;
+}
+
+static int pipe_pullTop(Pipe* pipe, PipeRow* row)
+{
+    if (!pipe->drained)
+    {
+        pipe_drain(pipe);
+    }
+
+    if (pipe->next >= pipe->size)
+    {
+        return 0;
+    }
+
+    *row = pipe->ranked[pipe->next++].row;
+
+    return 1;
+}
+
+Pipe* pipe_top(Pipe* from, int k, FilmField field)
+{
+    Pipe* pipe = pipe_new(from, pipe_pullTop);
+
+    pipe->count = k > 0 ? k : 0;
+    pipe->field = field;
+    pipe->ranked = (PipeRanked*)mvdb_alloc(pipe->count * sizeof(PipeRanked));
+
+    return pipe;
+}
+
+int pipe_next(Pipe* pipe, PipeRow* row)
+{
+    return pipe->pull(pipe, row);
+}
+
+long pipe_read(const Pipe* pipe)
+{
+    while (pipe->from != NULL)
+    {
+        pipe = pipe->from;
+    }
+
+    return pipe->read;
+}
+
+void pipe_free(Pipe* pipe)
+{
+    while (pipe != NULL)
+    {
+        Pipe* from = pipe->from;
+
+        free(pipe->text);
+        free(pipe->ranked);
+        free(pipe);
+        pipe = from;
+    }
+}
@@ -0,0 +1,248 @@
+/*
+ * File         : pipeline.h
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Header file that defines lazy queries over the movie
+ *                database. A query is a chain of stages, each pulling films
+ *                one at a time from the stage before it, down to a source
+ *                stage walking the list with its Iterator:
+ *
+ *                    Pipe* pipe = pipe_limit(pipe_project(pipe_years(
+ *                            pipe_genre(pipe_from(list), "Film-Noir"),
+ *                            1951, INT_MAX), FILM_TITLE), 3);
+ *
+ *                    while (pipe_next(pipe, &row)) ... row.text ...
+ *
+ *                    pipe_free(pipe);
+ *
+ *                Nothing is read until pipe_next is called, no list is made
+ *                between stages, and once a limit is reached nothing more is
+ *                read from the list, so "the first 3 Film-Noir titles after
+ *                1950" reads films only until the third is found.
+ *
+ *                Every stage but top-k passes films on in list order. Top-k
+ *                has to read everything before it to know the best k, but
+ *                only ever holds k films.
+ *
+ *                The list must not change while a query is reading it.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - Top-k kept in the heap of mvdb.h.
+ *                19/10/2026 v1.20 - Filter strings copied whole.
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "film.h"
+#include "moviedatabase.h"
+
+/*
+ * One result of a query. film is the film; after a project stage, text holds
+ * the projected field if it is a string (title, rating or genre), otherwise
+ * number holds it.
+ */
+typedef struct _PipeRow
+{
+    Film* film;
+    const char* text;
+    double number;
+}PipeRow;
+
+/*
+ * A film held by a top-k stage, with the field it is ranked by and its place
+ * among the films read, which ranks films with equal fields.
+ */
+typedef struct _PipeRanked
+{
+    PipeRow row;
+    double key;
+    long seq;
+}PipeRanked;
+
+typedef int (*PipeTest)(const Film* film, const void* argument);
+
+typedef struct _Pipe
+{
+    int (*pull)(struct _Pipe* pipe, PipeRow* row);
+    struct _Pipe* from;
+
+    /* source */
+    const List* list;
+    Iterator at;
+    long read;
+
+    /* filter */
+    PipeTest test;
+    const void* argument;
+    char* text;
+    int low;
+    int high;
+
+    /* project, top-k */
+    FilmField field;
+
+    /* skip, limit, top-k */
+    long count;
+    long seen;
+
+    /* top-k */
+    PipeRanked* ranked;
+    int size;
+    int next;
+    int drained;
+}Pipe;
+
+/*******************************************************************************
+
+Procedure   : pipe_from
+
+Parameters  : const List* list - a linked list of Film structs
+
+Returns     : Pipe* - a source stage passing on every film of list, in order
+
+Description : Starts a query. The list is read as films are pulled.
+
+ ******************************************************************************/
+Pipe* pipe_from(const List* list);
+
+/*******************************************************************************
+
+Procedure   : pipe_filter
+
+Parameters  : Pipe* from - stage to pull from
+              PipeTest test - returns non zero for films to keep
+              const void* argument - passed to test with each film
+
+Returns     : Pipe* - a stage passing on the films of from that pass test
+
+Description : pipe_genre, pipe_rating and pipe_years are filters with the
+              test written for them.
+
+ ******************************************************************************/
+Pipe* pipe_filter(Pipe* from, PipeTest test, const void* argument);
+
+/*******************************************************************************
+
+Procedure   : pipe_genre, pipe_rating, pipe_years
+
+Parameters  : Pipe* from - stage to pull from
+              const char* genre - genre token films must have (film_hasGenre)
+              const char* rating - certificate films must have (film_hasRating)
+              int low, int high - inclusive range of years films must be in
+
+Returns     : Pipe* - a filter stage
+
+Description : The strings are copied, so need not outlive the call.
+
+ ******************************************************************************/
+Pipe* pipe_genre(Pipe* from, const char* genre);
+Pipe* pipe_rating(Pipe* from, const char* rating);
+Pipe* pipe_years(Pipe* from, int low, int high);
+
+/*******************************************************************************
+
+Procedure   : pipe_project
+
+Parameters  : Pipe* from - stage to pull from
+              FilmField field - the field wanted
+
+Returns     : Pipe* - a stage setting row text or number to field of each film
+
+Description : Reads only field, so with lazily loaded films (see
+              list_populateLazy) the other fields are never decoded.
+
+ ******************************************************************************/
+Pipe* pipe_project(Pipe* from, FilmField field);
+
+/*******************************************************************************
+
+Procedure   : pipe_skip, pipe_limit
+
+Parameters  : Pipe* from - stage to pull from
+              long count - films to drop, or to pass on at most
+
+Returns     : Pipe* - a stage dropping the first count films of from, or
+                      passing on only the first count
+
+Description : A limit stage stops pulling from once count films have passed,
+              so the stages before it stop reading too.
+
+ ******************************************************************************/
+Pipe* pipe_skip(Pipe* from, long count);
+Pipe* pipe_limit(Pipe* from, long count);
+
+/*******************************************************************************
+
+Procedure   : pipe_top
+
+Parameters  : Pipe* from - stage to pull from
+              int k - number of films wanted
+              FilmField field - FILM_YEAR, FILM_LENGTH or FILM_REVIEWRATING
+
+Returns     : Pipe* - a stage passing on the k films of from with the highest
+                      field, highest first
+
+Description : On the first pull, reads every film of from into a heap of k
+              films, O(n log k), then passes them on. Films with equal
+              fields keep the order they came in, so the result is the
+              first k films a stable sort by field, highest first, would
+              give.
+
+ ******************************************************************************/
+Pipe* pipe_top(Pipe* from, int k, FilmField field);
+
+/*******************************************************************************
+
+Procedure   : pipe_next
+
+Parameters  : Pipe* pipe - last stage of a query
+              PipeRow* row - filled with the next result
+
+Returns     : int - 1 if row was filled, 0 when the query has no more results
+
+Description : Pulls one result through every stage of the query.
+
+ ******************************************************************************/
+int pipe_next(Pipe* pipe, PipeRow* row);
+
+/*******************************************************************************
+
+Procedure   : pipe_read
+
+Parameters  : const Pipe* pipe - any stage of a query
+
+Returns     : long - the number of films the query's source has read from
+                     the list so far
+
+Description : Shows how early a query stopped.
+
+ ******************************************************************************/
+long pipe_read(const Pipe* pipe);
+
+/*******************************************************************************
+
+Procedure   : pipe_free
+
+Parameters  : Pipe* pipe - last stage of a query
+
+Returns     : void
+
+Description : Frees pipe and every stage before it, but not the list or its
+              films.
+
+ ******************************************************************************/
+void pipe_free(Pipe* pipe);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PIPELINE_H */
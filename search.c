@@ -0,0 +1,304 @@
+/*
+ * File         : search.c
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Source file that implements the batch search described in
+ *                search.h.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - Results are temporary lists.
+ *                19/10/2026 v1.20 - Certificates tested with film_hasRating.
+ *                19/10/2026 v1.30 - Memory and clock from mvdb.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <float.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "search.h"
+#include "mvdb.h"
+
+/*
+ * A distinct genre or certificate string tested by one or more predicates.
+ */
+typedef struct _SearchTerm
+{
+    const char* text;
+    int rating;
+}SearchTerm;
+
+typedef struct _SearchPlan
+{
+    const SearchPredicate* predicates;
+    int count;
+    SearchTerm* terms;
+    int termCount;
+    int* genreTerms;
+    int* ratingTerms;
+}SearchPlan;
+
+typedef struct _SearchHits
+{
+    Film** films;
+    int count;
+    int size;
+}SearchHits;
+
+typedef struct _SearchWorker
+{
+    pthread_t thread;
+    const SearchPlan* plan;
+    Film** films;
+    int begin;
+    int end;
+    SearchHits* hits;
+}SearchWorker;
+
+void search_all(SearchPredicate* predicate)
+{
+    predicate->yearMin = INT_MIN;
+    predicate->yearMax = INT_MAX;
+    predicate->lengthMin = INT_MIN;
+    predicate->lengthMax = INT_MAX;
+    predicate->reviewMin = -FLT_MAX;
+    predicate->reviewMax = FLT_MAX;
+    predicate->genre = NULL;
+    predicate->rating = NULL;
+}
+
+/*
+ * Index of text among the plan's terms, added if it is not there yet, or -1
+ * for NULL. A batch holds a few hundred predicates at most, so a linear scan
+ * is enough.
+ */
+static int search_term(SearchPlan* plan, const char* text, int rating)
+{
+    if (text == NULL)
+    {
+        return -1;
+    }
+
+    for (int t = 0; t < plan->termCount; t++)
+    {
+        if (plan->terms[t].rating == rating
+                && strcmp(plan->terms[t].text, text) == 0)
+        {
+            return t;
+        }
+    }
+
+    plan->terms[plan->termCount].text = text;
+    plan->terms[plan->termCount].rating = rating;
+
+    return plan->termCount++;
+}
+
+static void search_plan(SearchPlan* plan, const SearchPredicate* predicates,
+        int count)
+{
+    plan->predicates = predicates;
+    plan->count = count;
+    plan->terms = (SearchTerm*)mvdb_alloc(2 * count * sizeof(SearchTerm));
+    plan->termCount = 0;
+    plan->genreTerms = (int*)mvdb_alloc(count * sizeof(int));
+    plan->ratingTerms = (int*)mvdb_alloc(count * sizeof(int));
+
+    for (int p = 0; p < count; p++)
+    {
+        plan->genreTerms[p] = search_term(plan, predicates[p].genre, 0);
+        plan->ratingTerms[p] = search_term(plan, predicates[p].rating, 1);
+    }
+}
+
+static void search_hit(SearchHits* hits, Film* film)
+{
+    if (hits->count == hits->size)
+    {
+        hits->size = hits->size == 0 ? 64 : hits->size * 2;
+        hits->films = (Film**)mvdb_grow(hits->films,
+                hits->size * sizeof(Film*));
+    }
+
+    hits->films[hits->count++] = film;
+}
+
+/*
+ * Tests term against the film of row, remembering the answer for the rest
+ * of the row: stamps[t] holds the last row term t was tested on.
+ */
+static int search_test(const SearchPlan* plan, int t, const Film* film,
+        int row, int* stamps, unsigned char* answers)
+{
+    if (stamps[t] != row)
+    {
+        const SearchTerm* term = &plan->terms[t];
+
+        stamps[t] = row;
+        answers[t] = term->rating
+                ? film_hasRating(film, term->text)
+                : film_hasGenre(film, term->text);
+    }
+
+    return answers[t];
+}
+
+static void* search_worker(void* argument)
+{
+    SearchWorker* worker = (SearchWorker*)argument;
+    const SearchPlan* plan = worker->plan;
+    int* stamps = (int*)mvdb_alloc(plan->termCount * sizeof(int));
+    unsigned char* answers = (unsigned char*)mvdb_alloc(plan->termCount);
+
+    for (int t = 0; t < plan->termCount; t++)
+    {
+        stamps[t] = -1;
+    }
+
+    for (int i = worker->begin; i < worker->end; i++)
+    {
+        Film* film = worker->films[i];
+        int year = film_getYear(film);
+        int length = film_getLength(film);
+        float reviewRating = film_getReviewRating(film);
+
+        for (int p = 0; p < plan->count; p++)
+        {
+            const SearchPredicate* predicate = &plan->predicates[p];
+
+            if (year < predicate->yearMin || year > predicate->yearMax
+                    || length < predicate->lengthMin
+                    || length > predicate->lengthMax
+                    || reviewRating < predicate->reviewMin
+                    || reviewRating > predicate->reviewMax)
+            {
+                continue;
+            }
+
+            if (plan->genreTerms[p] >= 0 && !search_test(plan,
+                    plan->genreTerms[p], film, i, stamps, answers))
+            {
+                continue;
+            }
+
+            if (plan->ratingTerms[p] >= 0 && !search_test(plan,
+                    plan->ratingTerms[p], film, i, stamps, answers))
+            {
+                continue;
+            }
+
+            search_hit(&worker->hits[p], film);
+        }
+    }
+
+    free(stamps);
+    free(answers);
+
+    return NULL;
+}
+
+SearchBatch* search_run(List* list, const SearchPredicate* predicates,
+        int count, int threads)
+{
+    double start = mvdb_now();
+    int films = list_length(list);
+    Film** rows = (Film**)mvdb_alloc(films * sizeof(Film*));
+    int f = 0;
+    SearchPlan plan;
+
+    for (Iterator i = list_begin(list); i != list_end(list);
+            i = iterator_next(i))
+    {
+        rows[f++] = iterator_value(i);
+    }
+
+    search_plan(&plan, predicates, count);
+
+    if (threads < 1 || films < SEARCH_PARALLEL_MIN)
+    {
+        threads = 1;
+    }
+
+    SearchWorker* workers = (SearchWorker*)mvdb_alloc(
+            threads * sizeof(SearchWorker));
+
+    for (int t = 0; t < threads; t++)
+    {
+        workers[t].plan = &plan;
+        workers[t].films = rows;
+        workers[t].begin = (int)((long)films * t / threads);
+        workers[t].end = (int)((long)films * (t + 1) / threads);
+        workers[t].hits = (SearchHits*)mvdb_alloc(
+                count * sizeof(SearchHits));
+
+        if (threads == 1)
+        {
+            search_worker(&workers[t]);
+        }
+        else
+        {
+            pthread_create(&workers[t].thread, NULL, search_worker,
+                    &workers[t]);
+        }
+    }
+
+    SearchBatch* batch = (SearchBatch*)mvdb_alloc(sizeof(SearchBatch));
+
+    batch->results = (List**)mvdb_alloc(count * sizeof(List*));
+    batch->count = count;
+    batch->threads = threads;
+    batch->rows = (long)films * count;
+
+    for (int p = 0; p < count; p++)
+    {
+        batch->results[p] = list_newTemporary();
+    }
+
+    /* Ranges are in list order, so joining them in turn keeps that order */
+    for (int t = 0; t < threads; t++)
+    {
+        if (threads > 1)
+        {
+            pthread_join(workers[t].thread, NULL);
+        }
+
+        for (int p = 0; p < count; p++)
+        {
+            for (int h = 0; h < workers[t].hits[p].count; h++)
+            {
+                list_add(batch->results[p], workers[t].hits[p].films[h]);
+            }
+
+            free(workers[t].hits[p].films);
+        }
+
+        free(workers[t].hits);
+    }
+
+    free(workers);
+    free(plan.terms);
+    free(plan.genreTerms);
+    free(plan.ratingTerms);
+    free(rows);
+
+    batch->seconds = mvdb_now() - start;
+
+    return batch;
+}
+
+void search_free(SearchBatch* batch)
+{
+    for (int p = 0; p < batch->count; p++)
+    {
+        list_free(batch->results[p]);
+    }
+
+    free(batch->results);
+    free(batch);
+}
@@ -0,0 +1,126 @@
+/*
+ * File         : search.h
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Header file that defines batch searching of the movie
+ *                database. Rather than one pass over the list per search, as
+ *                list_searchFilmNoir and list_searchSciFi make, a batch of
+ *                predicates is tested against each film in a single pass,
+ *                with the films split between threads.
+ *
+ *                Before the pass the batch is planned: the distinct genre
+ *                and certificate strings of all the predicates are listed,
+ *                so a string shared by many predicates is tested at most
+ *                once per film, and only when the cheaper range tests of
+ *                some predicate using it have passed.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - Results are temporary lists.
+ *                19/10/2026 v1.20 - Genres match whole tokens.
+ */
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "film.h"
+#include "moviedatabase.h"
+
+/*
+ * Collections smaller than this are searched on a single thread, as
+ * starting threads would cost more than it saves.
+ */
+#define SEARCH_PARALLEL_MIN 65536
+
+/*
+ * Films a predicate matches. Ranges are inclusive; genre matches films
+ * with it as one of their genre tokens (as film_hasGenre does) and rating
+ * films with exactly that certificate. NULL strings match everything.
+ */
+typedef struct _SearchPredicate
+{
+    int yearMin;
+    int yearMax;
+    int lengthMin;
+    int lengthMax;
+    float reviewMin;
+    float reviewMax;
+    const char* genre;
+    const char* rating;
+}SearchPredicate;
+
+/*
+ * Films matched by each predicate, in list order. results[p] belongs to
+ * predicates[p]. rows is the number of films times the number of
+ * predicates, the work a predicate at a time search would have done.
+ */
+typedef struct _SearchBatch
+{
+    List** results;
+    int count;
+    int threads;
+    long rows;
+    double seconds;
+}SearchBatch;
+
+/*******************************************************************************
+
+Procedure   : search_all
+
+Parameters  : SearchPredicate* predicate - predicate to set up
+
+Returns     : void
+
+Description : Sets predicate to match every film, ready for single fields to
+              be narrowed.
+
+ ******************************************************************************/
+void search_all(SearchPredicate* predicate);
+
+/*******************************************************************************
+
+Procedure   : search_run
+
+Parameters  : List* list - a filled linked list of Film structs
+              const SearchPredicate* predicates - the predicates to test
+              int count - number of predicates
+              int threads - most threads to search with
+
+Returns     : SearchBatch* - one list of matching films per predicate
+
+Description : Plans the batch, then splits the films into one range per
+              thread. Each thread tests every predicate against each film
+              of its range and collects its own matches; the matches are
+              then joined in thread order, so every result is in list
+              order. The result lists hold the same films as list, which
+              still owns them, and are temporary lists (see 
+              list_newTemporary), counted as results until search_free.
+
+ ******************************************************************************/
+SearchBatch* search_run(List* list, const SearchPredicate* predicates,
+        int count, int threads);
+
+/*******************************************************************************
+
+Procedure   : search_free
+
+Parameters  : SearchBatch* batch - results from search_run
+
+Returns     : void
+
+Description : Frees the result lists, but not the films in them.
+
+ ******************************************************************************/
+void search_free(SearchBatch* batch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SEARCH_H */
@@ -0,0 +1,811 @@
+/*
+ * File         : server.c
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Source file that implements the long running query server
+ *                described in server.h. Requests read in the same turn of the
+ *                event loop are batched and answered from one shared scan.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - Memory and clock from mvdb.h.
+ *                19/10/2026 v1.20 - TOP results kept in the heap of mvdb.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "server.h"
+#include "mvdb.h"
+
+#define SERVER_BACKLOG   64
+#define SERVER_MAX_BATCH 1024
+#define SERVER_MAX_LINE  4096
+#define SERVER_SAMPLES   65536
+#define SERVER_MAX_K     100000
+
+typedef enum
+{
+    QUERY_GENRE,
+    QUERY_TOP,
+    QUERY_RANGE,
+    QUERY_TITLE,
+    QUERY_STATS,
+    QUERY_QUIT,
+    QUERY_ERROR
+}QueryType;
+
+typedef enum
+{
+    FIELD_YEAR,
+    FIELD_LENGTH,
+    FIELD_REVIEW
+}QueryField;
+
+typedef struct _Client
+{
+    int fd;
+    char* in;
+    size_t inLength;
+    size_t inSize;
+    char* out;
+    size_t outLength;
+    size_t outSize;
+    size_t outSent;
+    int closing;
+}Client;
+
+/*
+ * A film kept by a TOP request, with the field it is ranked by and its place
+ * in the list, which ranks films with equal fields.
+ */
+typedef struct _RequestRanked
+{
+    Film* film;
+    double key;
+    long seq;
+}RequestRanked;
+
+typedef struct _Request
+{
+    int client;
+    QueryType type;
+    QueryField field;
+    char* text;
+    double low;
+    double high;
+    int k;
+    Film** results;
+    int count;
+    int size;
+    RequestRanked* ranked;
+    long seen;
+    double arrived;
+}Request;
+
+static volatile sig_atomic_t server_stop = 0;
+
+static double server_samples[SERVER_SAMPLES];
+static long server_requests = 0;
+
+static void server_signal(int signal)
+{
+    (void)signal;
+    server_stop = 1;
+}
+
+static double server_elapsed(double since)
+{
+    return (mvdb_now() - since) * 1e6;
+}
+
+static void server_record(double micros)
+{
+    server_samples[server_requests % SERVER_SAMPLES] = micros;
+    server_requests++;
+}
+
+static int server_compareSamples(const void* a, const void* b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+
+    return (x > y) - (x < y);
+}
+
+/*
+ * Work out the p50 and p99 over the most recent SERVER_SAMPLES requests.
+ */
+static void server_percentiles(double* p50, double* p99)
+{
+    long count = server_requests < SERVER_SAMPLES
+            ? server_requests : SERVER_SAMPLES;
+
+    *p50 = *p99 = 0;
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    double* sorted = (double*)mvdb_alloc(count * sizeof(double));
+
+    memcpy(sorted, server_samples, count * sizeof(double));
+    qsort(sorted, count, sizeof(double), server_compareSamples);
+
+    *p50 = sorted[(count - 1) * 50 / 100];
+    *p99 = sorted[(count - 1) * 99 / 100];
+
+    free(sorted);
+}
+
+static void server_grow(char** buffer, size_t* size, size_t needed)
+{
+    if (needed <= *size)
+    {
+        return;
+    }
+
+    size_t grown = *size == 0 ? 1024 : *size;
+
+    while (grown < needed)
+    {
+        grown *= 2;
+    }
+
+    char* resized = (char*)mvdb_grow(*buffer, grown);
+
+    *buffer = resized;
+    *size = grown;
+}
+
+static void client_append(Client* client, const char* text, size_t length)
+{
+    server_grow(&client->out, &client->outSize, client->outLength + length);
+    memcpy(client->out + client->outLength, text, length);
+    client->outLength += length;
+}
+
+static void client_printf(Client* client, const char* format, ...)
+{
+    char line[256];
+    va_list args;
+
+    va_start(args, format);
+    int length = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    if (length >= (int)sizeof(line))
+    {
+        length = sizeof(line) - 1;
+    }
+
+    client_append(client, line, length);
+}
+
+static void client_appendFilm(Client* client, const Film* film)
+{
+    char line[512];
+    int length = film_toLine(film, line, sizeof(line));
+
+    if (length >= (int)sizeof(line))
+    {
+        /* Title longer than the line buffer, format it on the heap */
+        char* longLine = (char*)mvdb_alloc(length + 1);
+
+        film_toLine(film, longLine, length + 1);
+        client_append(client, longLine, length);
+        free(longLine);
+    }
+    else
+    {
+        client_append(client, line, length);
+    }
+}
+
+static int server_parseField(const char* name, QueryField* field)
+{
+    if (name == NULL)
+    {
+        return 0;
+    }
+    if (strcmp(name, "year") == 0)
+    {
+        *field = FIELD_YEAR;
+    }
+    else if (strcmp(name, "length") == 0)
+    {
+        *field = FIELD_LENGTH;
+    }
+    else if (strcmp(name, "review") == 0)
+    {
+        *field = FIELD_REVIEW;
+    }
+    else
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+static double server_fieldValue(const Film* film, QueryField field)
+{
+    switch (field)
+    {
+        case FIELD_YEAR:
+            return film_getYear(film);
+        case FIELD_LENGTH:
+            return film_getLength(film);
+        default:
+            return film_getReviewRating(film);
+    }
+}
+
+/*
+ * Turns one protocol line into a request. Anything that does not parse is
+ * kept as a QUERY_ERROR so that replies stay in the order they were asked.
+ */
+static void server_parseRequest(char* line, Request* request)
+{
+    char* rest = NULL;
+    char* command = strtok_r(line, " \t", &rest);
+
+    memset(request, 0, sizeof(Request));
+    request->type = QUERY_ERROR;
+    request->text = "unknown command";
+
+    if (command == NULL)
+    {
+        request->text = "empty request";
+    }
+    else if (strcmp(command, "GENRE") == 0)
+    {
+        char* genre = strtok_r(NULL, " \t", &rest);
+
+        if (genre == NULL)
+        {
+            request->text = "usage: GENRE <token>";
+            return;
+        }
+
+        request->type = QUERY_GENRE;
+        request->text = strdup(genre);
+    }
+    else if (strcmp(command, "TOP") == 0)
+    {
+        char* k = NULL;
+
+        if (!server_parseField(strtok_r(NULL, " \t", &rest), &request->field)
+                || (k = strtok_r(NULL, " \t", &rest)) == NULL || atoi(k) <= 0
+                || atoi(k) > SERVER_MAX_K)
+        {
+            request->text = "usage: TOP <year|length|review> <k>";
+            return;
+        }
+
+        request->type = QUERY_TOP;
+        request->k = atoi(k);
+        request->results = (Film**)mvdb_alloc(request->k * sizeof(Film*));
+        request->size = request->k;
+        request->ranked = (RequestRanked*)mvdb_alloc(request->k
+                * sizeof(RequestRanked));
+    }
+    else if (strcmp(command, "RANGE") == 0)
+    {
+        char* low = NULL;
+        char* high = NULL;
+
+        if (!server_parseField(strtok_r(NULL, " \t", &rest), &request->field)
+                || (low = strtok_r(NULL, " \t", &rest)) == NULL
+                || (high = strtok_r(NULL, " \t", &rest)) == NULL)
+        {
+            request->text = "usage: RANGE <year|length|review> <lo> <hi>";
+            return;
+        }
+
+        request->type = QUERY_RANGE;
+        request->low = atof(low);
+        request->high = atof(high);
+    }
+    else if (strcmp(command, "TITLE") == 0)
+    {
+        rest += strspn(rest, " \t");
+
+        if (*rest == '\0')
+        {
+            request->text = "usage: TITLE <title>";
+            return;
+        }
+
+        request->type = QUERY_TITLE;
+        request->text = strdup(rest);
+    }
+    else if (strcmp(command, "STATS") == 0)
+    {
+        request->type = QUERY_STATS;
+    }
+    else if (strcmp(command, "QUIT") == 0)
+    {
+        request->type = QUERY_QUIT;
+    }
+}
+
+static void request_addResult(Request* request, Film* film)
+{
+    if (request->count == request->size)
+    {
+        int size = request->size == 0 ? 16 : request->size * 2;
+        Film** results = (Film**)mvdb_grow(request->results,
+                size * sizeof(Film*));
+
+        request->results = results;
+        request->size = size;
+    }
+
+    request->results[request->count++] = film;
+}
+
+/*
+ * Highest field first, and of equal fields the one first in the list. TOP
+ * requests keep their k best films in a heap in this order, so the worst of
+ * them is at ranked[0] and can be replaced in O(log k).
+ */
+static int request_byKey(const void* a, const void* b)
+{
+    const RequestRanked* x = (const RequestRanked*)a;
+    const RequestRanked* y = (const RequestRanked*)b;
+
+    if (x->key != y->key)
+    {
+        return x->key > y->key ? -1 : 1;
+    }
+
+    return x->seq < y->seq ? -1 : x->seq > y->seq;
+}
+
+static void request_offerTop(Request* request, Film* film)
+{
+    RequestRanked entry = { film, server_fieldValue(film, request->field),
+            request->seen++ };
+
+    if (request->count < request->k)
+    {
+        request->ranked[request->count++] = entry;
+        mvdb_heapUp(request->ranked, request->count, sizeof(RequestRanked),
+                request_byKey);
+    }
+    else if (entry.key > request->ranked[0].key)
+    {
+        request->ranked[0] = entry;
+        mvdb_heapDown(request->ranked, request->count, sizeof(RequestRanked),
+                request_byKey);
+    }
+}
+
+/*
+ * Sorts the TOP results so they come out highest first.
+ */
+static void request_finishTop(Request* request)
+{
+    mvdb_heapSort(request->ranked, request->count, sizeof(RequestRanked),
+            request_byKey);
+
+    for (int i = 0; i < request->count; i++)
+    {
+        request->results[i] = request->ranked[i].film;
+    }
+}
+
+/*
+ * Answers every scan based request in the batch with a single pass over the
+ * linked list, so the cost of walking the list is shared between them.
+ */
+static void server_execute(List* list, Request* batch, int count)
+{
+    int scans = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (batch[i].type <= QUERY_TITLE)
+        {
+            scans++;
+        }
+    }
+
+    if (scans == 0)
+    {
+        return;
+    }
+
+    for (Iterator i = list_begin(list); i != list_end(list);
+            i = iterator_next(i))
+    {
+        Film* film = iterator_value(i);
+
+        for (int r = 0; r < count; r++)
+        {
+            Request* request = &batch[r];
+
+            switch (request->type)
+            {
+                case QUERY_GENRE:
+                    if (film_hasGenre(film, request->text))
+                    {
+                        request_addResult(request, film);
+                    }
+                    break;
+                case QUERY_TOP:
+                    request_offerTop(request, film);
+                    break;
+                case QUERY_RANGE:
+                {
+                    double value = server_fieldValue(film, request->field);
+
+                    if (value >= request->low && value <= request->high)
+                    {
+                        request_addResult(request, film);
+                    }
+                    break;
+                }
+                case QUERY_TITLE:
+                    if (strcmp(film_getTitle(film), request->text) == 0)
+                    {
+                        request_addResult(request, film);
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    for (int r = 0; r < count; r++)
+    {
+        if (batch[r].type == QUERY_TOP)
+        {
+            request_finishTop(&batch[r]);
+        }
+    }
+}
+
+static void server_reply(Client* clients, Request* request)
+{
+    Client* client = &clients[request->client];
+
+    switch (request->type)
+    {
+        case QUERY_STATS:
+        {
+            double p50, p99;
+            server_percentiles(&p50, &p99);
+            client_printf(client, "OK 0 requests=%ld p50=%.1fus p99=%.1fus\n",
+                    server_requests, p50, p99);
+            break;
+        }
+        case QUERY_QUIT:
+            client_printf(client, "OK 0\n");
+            client->closing = 1;
+            break;
+        case QUERY_ERROR:
+            client_printf(client, "ERR %s\n", request->text);
+            break;
+        default:
+            client_printf(client, "OK %d\n", request->count);
+
+            for (int i = 0; i < request->count; i++)
+            {
+                client_appendFilm(client, request->results[i]);
+            }
+            break;
+    }
+
+    server_record(server_elapsed(request->arrived));
+
+    if (request->type == QUERY_GENRE || request->type == QUERY_TITLE)
+    {
+        free(request->text);
+    }
+
+    free(request->results);
+    free(request->ranked);
+}
+
+/*
+ * Pulls complete lines out of a client's input buffer and queues them in the
+ * batch. Returns 1 if lines are left over because the batch filled up.
+ */
+static int server_takeLines(Client* clients, int index, Request* batch,
+        int* count)
+{
+    Client* client = &clients[index];
+    size_t start = 0;
+    int leftOver = 0;
+
+    while (start < client->inLength)
+    {
+        char* newline = memchr(client->in + start, '\n',
+                client->inLength - start);
+
+        if (newline == NULL)
+        {
+            break;
+        }
+        if (*count == SERVER_MAX_BATCH)
+        {
+            leftOver = 1;
+            break;
+        }
+
+        *newline = '\0';
+
+        if (newline > client->in + start && newline[-1] == '\r')
+        {
+            newline[-1] = '\0';
+        }
+
+        Request* request = &batch[(*count)++];
+        server_parseRequest(client->in + start, request);
+        request->client = index;
+        request->arrived = mvdb_now();
+
+        start = newline - client->in + 1;
+    }
+
+    memmove(client->in, client->in + start, client->inLength - start);
+    client->inLength -= start;
+
+    if (client->inLength > SERVER_MAX_LINE && !leftOver)
+    {
+        /* A line this long is never going to be a valid request */
+        client->closing = 1;
+        client->inLength = 0;
+    }
+
+    return leftOver;
+}
+
+static void client_read(Client* client)
+{
+    for (;;)
+    {
+        server_grow(&client->in, &client->inSize, client->inLength + 4096);
+
+        ssize_t got = read(client->fd, client->in + client->inLength,
+                client->inSize - client->inLength);
+
+        if (got > 0)
+        {
+            client->inLength += got;
+        }
+        else if (got == 0)
+        {
+            client->closing = 1;
+            return;
+        }
+        else
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            {
+                client->closing = 1;
+                client->outLength = client->outSent = 0;
+            }
+            return;
+        }
+    }
+}
+
+static void client_flush(Client* client)
+{
+    while (client->outSent < client->outLength)
+    {
+        ssize_t sent = write(client->fd, client->out + client->outSent,
+                client->outLength - client->outSent);
+
+        if (sent < 0)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            {
+                client->closing = 1;
+                client->outLength = client->outSent = 0;
+            }
+            return;
+        }
+
+        client->outSent += sent;
+    }
+
+    client->outLength = client->outSent = 0;
+}
+
+static int server_listen(const char* path)
+{
+    struct sockaddr_un address;
+
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        fprintf(stderr, "Error: socket path '%s' is too long\n", path);
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (fd < 0)
+    {
+        perror("Error: socket");
+        return -1;
+    }
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+    unlink(path);
+
+    if (bind(fd, (struct sockaddr*)&address, sizeof(address)) < 0
+            || listen(fd, SERVER_BACKLOG) < 0)
+    {
+        perror("Error: unable to listen on socket");
+        close(fd);
+        return -1;
+    }
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    return fd;
+}
+
+int server_run(List* list, const char* path)
+{
+    int listener = server_listen(path);
+
+    if (listener < 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = server_signal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    Client* clients = NULL;
+    int clientCount = 0;
+    int clientSize = 0;
+    struct pollfd* fds = NULL;
+    Request* batch = (Request*)mvdb_alloc(SERVER_MAX_BATCH * sizeof(Request));
+    int pending = 0;
+
+    printf("MVDB server listening on %s (%i films)\n", path,
+            list_length(list));
+    fflush(stdout);
+
+    while (!server_stop)
+    {
+        if (clientSize < clientCount + 1 || fds == NULL)
+        {
+            clientSize = clientSize == 0 ? 16 : clientSize * 2;
+            clients = (Client*)mvdb_grow(clients, clientSize * sizeof(Client));
+            fds = (struct pollfd*)mvdb_grow(fds,
+                    (clientSize + 1) * sizeof(struct pollfd));
+        }
+
+        fds[0].fd = listener;
+        fds[0].events = POLLIN;
+
+        for (int c = 0; c < clientCount; c++)
+        {
+            fds[c + 1].fd = clients[c].fd;
+            fds[c + 1].events = POLLIN;
+
+            if (clients[c].outLength > clients[c].outSent)
+            {
+                fds[c + 1].events |= POLLOUT;
+            }
+        }
+
+        /* Lines left over from a full batch are served without waiting */
+        if (poll(fds, clientCount + 1, pending ? 0 : -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            perror("Error: poll");
+            break;
+        }
+
+        int batchCount = 0;
+        pending = 0;
+
+        for (int c = 0; c < clientCount; c++)
+        {
+            if (fds[c + 1].revents & (POLLIN | POLLHUP | POLLERR))
+            {
+                client_read(&clients[c]);
+            }
+
+            pending |= server_takeLines(clients, c, batch, &batchCount);
+        }
+
+        server_execute(list, batch, batchCount);
+
+        for (int r = 0; r < batchCount; r++)
+        {
+            server_reply(clients, &batch[r]);
+        }
+
+        for (int c = 0; c < clientCount; c++)
+        {
+            client_flush(&clients[c]);
+        }
+
+        /* Drop clients that have gone away once their replies are sent */
+        int kept = 0;
+
+        for (int c = 0; c < clientCount; c++)
+        {
+            if (clients[c].closing && clients[c].outLength == 0)
+            {
+                close(clients[c].fd);
+                free(clients[c].in);
+                free(clients[c].out);
+            }
+            else
+            {
+                clients[kept++] = clients[c];
+            }
+        }
+
+        clientCount = kept;
+
+        if (fds[0].revents & POLLIN)
+        {
+            int fd;
+
+            while (clientCount < clientSize
+                    && (fd = accept(listener, NULL, NULL)) >= 0)
+            {
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+                memset(&clients[clientCount], 0, sizeof(Client));
+                clients[clientCount++].fd = fd;
+            }
+
+            /* Come straight back round if the client table filled up */
+            pending |= clientCount == clientSize;
+        }
+    }
+
+    double p50, p99;
+    server_percentiles(&p50, &p99);
+    printf("\nMVDB server stopped after %ld requests: p50 %.1fus, "
+            "p99 %.1fus\n", server_requests, p50, p99);
+
+    for (int c = 0; c < clientCount; c++)
+    {
+        close(clients[c].fd);
+        free(clients[c].in);
+        free(clients[c].out);
+    }
+
+    free(clients);
+    free(fds);
+    free(batch);
+    close(listener);
+    unlink(path);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,64 @@
+/*
+ * File         : server.h
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Header file that defines a long running query server for the
+ *                movie database. The collection is loaded once and queries are
+ *                answered over a Unix domain socket using a line protocol:
+ *
+ *                  GENRE <token>                      films in a genre
+ *                  TOP <year|length|review> <k>       k highest by a field
+ *                  RANGE <year|length|review> <lo> <hi>
+ *                                                     films within a range
+ *                  TITLE <title>                      exact title lookup
+ *                  STATS                              request latencies
+ *                  QUIT                               close the connection
+ *
+ *                Every reply starts with "OK <n>" followed by n film lines in
+ *                the films.txt format, or a single "ERR <message>" line.
+ *
+ * History      : 19/10/2026 v1.00
+ */
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "moviedatabase.h"
+
+/*
+ * Default location of the server socket when none is given on the command
+ * line.
+ */
+#define SERVER_SOCKET "mvdb.sock"
+
+/*******************************************************************************
+
+Procedure   : server_run
+
+Parameters  : List* list - a filled linked list of Film structs
+              const char* path - file system path of the Unix domain socket
+
+Returns     : int - EXIT_SUCCESS once the server has been shut down,
+                    EXIT_FAILURE if the socket could not be set up
+
+Description : Listens on the socket and services clients from a single poll()
+              event loop. All requests that arrive in one turn of the loop are
+              gathered into a batch and answered together from one shared scan
+              of the linked list. Runs until SIGINT or SIGTERM is received,
+              then prints the p50/p99 request latency.
+
+ ******************************************************************************/
+int server_run(List* list, const char* path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SERVER_H */
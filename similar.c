@@ -0,0 +1,701 @@
+/*
+ * File         : similar.c
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Source file that implements the similar films index
+ *                described in similar.h.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - Memory allocated through mvdb.h.
+ *                19/10/2026 v1.20 - Top-k kept in the heap of mvdb.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "similar.h"
+#include "mvdb.h"
+
+#if !defined(SIMILAR_SCALAR) && defined(__AVX2__)
+#include <immintrin.h>
+#define SIMILAR_WIDTH 8
+
+typedef __m256 SimilarVector;
+
+#define similar_load _mm256_loadu_ps
+#define similar_store _mm256_storeu_ps
+#define similar_fill _mm256_set1_ps
+#define similar_add _mm256_add_ps
+#define similar_sub _mm256_sub_ps
+#define similar_mul _mm256_mul_ps
+#define similar_div _mm256_div_ps
+#define similar_max _mm256_max_ps
+
+/*
+ * Bits set in each 64 bit lane of x, in the low bits of the lane.
+ */
+static inline __m256i similar_count(__m256i x)
+{
+    const __m256i m1 = _mm256_set1_epi8(0x55);
+    const __m256i m2 = _mm256_set1_epi8(0x33);
+    const __m256i m4 = _mm256_set1_epi8(0x0f);
+
+    x = _mm256_sub_epi64(x, _mm256_and_si256(_mm256_srli_epi64(x, 1), m1));
+    x = _mm256_add_epi64(_mm256_and_si256(x, m2),
+            _mm256_and_si256(_mm256_srli_epi64(x, 2), m2));
+    x = _mm256_and_si256(_mm256_add_epi64(x, _mm256_srli_epi64(x, 4)), m4);
+
+    return _mm256_sad_epu8(x, _mm256_setzero_si256());
+}
+
+/*
+ * Genre tokens each of 8 films shares with the query.
+ */
+static inline SimilarVector similar_shared(const uint64_t* genres,
+        uint64_t query)
+{
+    __m256i mask = _mm256_set1_epi64x((long long)query);
+    __m256i a = similar_count(_mm256_and_si256(mask,
+            _mm256_loadu_si256((const __m256i*)genres)));
+    __m256i b = similar_count(_mm256_and_si256(mask,
+            _mm256_loadu_si256((const __m256i*)(genres + 4))));
+
+    /* Low halves of each lane are films 0 1 4 5 2 3 6 7; put them in order */
+    __m256i counts = _mm256_castps_si256(_mm256_shuffle_ps(
+            _mm256_castsi256_ps(a), _mm256_castsi256_ps(b),
+            _MM_SHUFFLE(2, 0, 2, 0)));
+
+    return _mm256_cvtepi32_ps(_mm256_permute4x64_epi64(counts,
+            _MM_SHUFFLE(3, 1, 2, 0)));
+}
+#elif !defined(SIMILAR_SCALAR) && defined(__SSE2__)
+#include <emmintrin.h>
+#define SIMILAR_WIDTH 4
+
+typedef __m128 SimilarVector;
+
+#define similar_load _mm_loadu_ps
+#define similar_store _mm_storeu_ps
+#define similar_fill _mm_set1_ps
+#define similar_add _mm_add_ps
+#define similar_sub _mm_sub_ps
+#define similar_mul _mm_mul_ps
+#define similar_div _mm_div_ps
+#define similar_max _mm_max_ps
+
+static inline __m128i similar_count(__m128i x)
+{
+    const __m128i m1 = _mm_set1_epi8(0x55);
+    const __m128i m2 = _mm_set1_epi8(0x33);
+    const __m128i m4 = _mm_set1_epi8(0x0f);
+
+    x = _mm_sub_epi64(x, _mm_and_si128(_mm_srli_epi64(x, 1), m1));
+    x = _mm_add_epi64(_mm_and_si128(x, m2),
+            _mm_and_si128(_mm_srli_epi64(x, 2), m2));
+    x = _mm_and_si128(_mm_add_epi64(x, _mm_srli_epi64(x, 4)), m4);
+
+    return _mm_sad_epu8(x, _mm_setzero_si128());
+}
+
+static inline SimilarVector similar_shared(const uint64_t* genres,
+        uint64_t query)
+{
+    __m128i mask = _mm_set1_epi64x((long long)query);
+    __m128i a = similar_count(_mm_and_si128(mask,
+            _mm_loadu_si128((const __m128i*)genres)));
+    __m128i b = similar_count(_mm_and_si128(mask,
+            _mm_loadu_si128((const __m128i*)(genres + 2))));
+
+    return _mm_cvtepi32_ps(_mm_castps_si128(_mm_shuffle_ps(
+            _mm_castsi128_ps(a), _mm_castsi128_ps(b),
+            _MM_SHUFFLE(2, 0, 2, 0))));
+}
+#endif
+
+/*
+ * A film's features, scaled as the index scales them.
+ */
+typedef struct _SimilarQuery
+{
+    uint64_t genres;
+    float tokens;
+    float fields[3];
+}SimilarQuery;
+
+/*
+ * A film kept by a search: its distance and its position in the index.
+ */
+typedef struct _SimilarNear
+{
+    float distance;
+    int position;
+}SimilarNear;
+
+/*
+ * A search's top-k heap, worst film at the root, and the distances of the
+ * block being searched.
+ */
+typedef struct _SimilarScratch
+{
+    SimilarNear* near;
+    float* block;
+}SimilarScratch;
+
+typedef struct _SimilarWorker
+{
+    pthread_t thread;
+    const Similar* index;
+    int k;
+    int begin;
+    int end;
+    SimilarMatch* matches;
+}SimilarWorker;
+
+/*
+ * The distance formula of similar.h. tokens is |a| + |b|. Every kernel works
+ * it out in this order, so gives the same float.
+ */
+static inline float similar_score(float shared, float tokens, float year,
+        float length, float rating)
+{
+    float genre = 1.0f - 2.0f * shared / (tokens < 1.0f ? 1.0f : tokens);
+
+    return SIMILAR_GENRE * genre + SIMILAR_YEAR * year * year
+            + SIMILAR_LENGTH * length * length
+            + SIMILAR_RATING * rating * rating;
+}
+
+/*
+ * Bit of a genre token, or -1 if it has none. Only the index being built
+ * passes adding, to give new tokens a bit.
+ */
+static int similar_token(const Similar* index, Similar* adding,
+        const char* token)
+{
+    for (int t = 0; t < index->nameCount; t++)
+    {
+        if (strcmp(index->names[t], token) == 0)
+        {
+            return t;
+        }
+    }
+
+    if (adding == NULL || adding->nameCount == SIMILAR_TOKENS)
+    {
+        return -1;
+    }
+
+    snprintf(adding->names[adding->nameCount],
+            sizeof(adding->names[adding->nameCount]), "%s", token);
+
+    return adding->nameCount++;
+}
+
+static void similar_features(const Similar* index, Similar* adding,
+        const Film* film, SimilarQuery* query)
+{
+    char genre[sizeof(film->genre)];
+    char* save = NULL;
+
+    snprintf(genre, sizeof(genre), "%s", film_getGenre(film));
+
+    query->genres = 0;
+    query->tokens = 0;
+
+    for (char* token = strtok_r(genre, "/", &save); token != NULL;
+            token = strtok_r(NULL, "/", &save))
+    {
+        int bit = similar_token(index, adding, token);
+
+        if (bit < 0)
+        {
+            query->tokens++;
+        }
+        else if (!(query->genres & (1ull << bit)))
+        {
+            query->genres |= 1ull << bit;
+            query->tokens++;
+        }
+    }
+
+    float values[3] = { (float)film_getYear(film),
+            (float)film_getLength(film), film_getReviewRating(film) };
+
+    for (int f = 0; f < 3; f++)
+    {
+        query->fields[f] = (values[f] - index->low[f]) * index->scale[f];
+    }
+}
+
+static void similar_at(const Similar* index, int p, SimilarQuery* query)
+{
+    query->genres = index->genres[p];
+    query->tokens = index->tokens[p];
+    query->fields[0] = index->years[p];
+    query->fields[1] = index->lengths[p];
+    query->fields[2] = index->ratings[p];
+}
+
+/*
+ * Films sorted by year, in list order within a year.
+ */
+typedef struct _SimilarRow
+{
+    Film* film;
+    int year;
+    int order;
+}SimilarRow;
+
+static int similar_compare(const void* a, const void* b)
+{
+    const SimilarRow* x = (const SimilarRow*)a;
+    const SimilarRow* y = (const SimilarRow*)b;
+
+    if (x->year != y->year)
+    {
+        return x->year < y->year ? -1 : 1;
+    }
+
+    return x->order < y->order ? -1 : x->order > y->order;
+}
+
+Similar* similar_new(List* list)
+{
+    Similar* index = (Similar*)mvdb_alloc(sizeof(Similar));
+    int count = list_length(list);
+    SimilarRow* rows = (SimilarRow*)mvdb_alloc(count * sizeof(SimilarRow));
+    float high[3] = { 0 };
+    int n = 0;
+
+    for (Iterator i = list_begin(list); i != list_end(list);
+            i = iterator_next(i))
+    {
+        Film* film = iterator_value(i);
+        float values[3] = { (float)film_getYear(film),
+                (float)film_getLength(film), film_getReviewRating(film) };
+
+        for (int f = 0; f < 3; f++)
+        {
+            if (n == 0 || values[f] < index->low[f])
+            {
+                index->low[f] = values[f];
+            }
+            if (n == 0 || values[f] > high[f])
+            {
+                high[f] = values[f];
+            }
+        }
+
+        rows[n].film = film;
+        rows[n].year = film_getYear(film);
+        rows[n].order = n;
+        n++;
+    }
+
+    qsort(rows, count, sizeof(SimilarRow), similar_compare);
+
+    for (int f = 0; f < 3; f++)
+    {
+        index->scale[f] = count > 0 && high[f] > index->low[f]
+                ? 1.0f / (high[f] - index->low[f]) : 0.0f;
+    }
+
+    /* Padded to whole blocks, so the kernel never needs a tail loop */
+    int size;
+
+    index->count = count;
+    index->blockCount = (count + SIMILAR_BLOCK - 1) / SIMILAR_BLOCK;
+    size = index->blockCount * SIMILAR_BLOCK;
+    index->films = (Film**)mvdb_alloc(size * sizeof(Film*));
+    index->genres = (uint64_t*)mvdb_alloc(size * sizeof(uint64_t));
+    index->tokens = (float*)mvdb_alloc(size * sizeof(float));
+    index->years = (float*)mvdb_alloc(size * sizeof(float));
+    index->lengths = (float*)mvdb_alloc(size * sizeof(float));
+    index->ratings = (float*)mvdb_alloc(size * sizeof(float));
+    index->blocks = (SimilarBlock*)mvdb_alloc(
+            index->blockCount * sizeof(SimilarBlock));
+
+    for (int p = 0; p < count; p++)
+    {
+        SimilarQuery features;
+        SimilarBlock* block = &index->blocks[p / SIMILAR_BLOCK];
+
+        similar_features(index, index, rows[p].film, &features);
+
+        index->films[p] = rows[p].film;
+        index->genres[p] = features.genres;
+        index->tokens[p] = features.tokens;
+        index->years[p] = features.fields[0];
+        index->lengths[p] = features.fields[1];
+        index->ratings[p] = features.fields[2];
+
+        for (int f = 0; f < 3; f++)
+        {
+            if (p % SIMILAR_BLOCK == 0 || features.fields[f] < block->low[f])
+            {
+                block->low[f] = features.fields[f];
+            }
+            if (p % SIMILAR_BLOCK == 0 || features.fields[f] > block->high[f])
+            {
+                block->high[f] = features.fields[f];
+            }
+        }
+    }
+
+    free(rows);
+
+    return index;
+}
+
+float similar_distance(const Similar* index, const Film* a, const Film* b)
+{
+    SimilarQuery x;
+    SimilarQuery y;
+
+    similar_features(index, NULL, a, &x);
+    similar_features(index, NULL, b, &y);
+
+    return similar_score((float)__builtin_popcountll(x.genres & y.genres),
+            x.tokens + y.tokens, y.fields[0] - x.fields[0],
+            y.fields[1] - x.fields[1], y.fields[2] - x.fields[2]);
+}
+
+/*
+ * Distances from query to the SIMILAR_BLOCK films from begin.
+ */
+static void similar_kernel(const Similar* index, const SimilarQuery* query,
+        int begin, float* distances)
+{
+#ifdef SIMILAR_WIDTH
+    SimilarVector one = similar_fill(1.0f);
+    SimilarVector two = similar_fill(2.0f);
+    SimilarVector tokens = similar_fill(query->tokens);
+    SimilarVector year = similar_fill(query->fields[0]);
+    SimilarVector length = similar_fill(query->fields[1]);
+    SimilarVector rating = similar_fill(query->fields[2]);
+    SimilarVector genreWeight = similar_fill(SIMILAR_GENRE);
+    SimilarVector yearWeight = similar_fill(SIMILAR_YEAR);
+    SimilarVector lengthWeight = similar_fill(SIMILAR_LENGTH);
+    SimilarVector ratingWeight = similar_fill(SIMILAR_RATING);
+
+    for (int i = 0; i < SIMILAR_BLOCK; i += SIMILAR_WIDTH)
+    {
+        int p = begin + i;
+        SimilarVector shared = similar_shared(index->genres + p,
+                query->genres);
+        SimilarVector total = similar_max(similar_add(tokens,
+                similar_load(index->tokens + p)), one);
+        SimilarVector genre = similar_sub(one,
+                similar_div(similar_mul(two, shared), total));
+        SimilarVector dy = similar_sub(similar_load(index->years + p), year);
+        SimilarVector dl = similar_sub(similar_load(index->lengths + p),
+                length);
+        SimilarVector dr = similar_sub(similar_load(index->ratings + p),
+                rating);
+        SimilarVector distance = similar_add(similar_add(similar_add(
+                similar_mul(genreWeight, genre),
+                similar_mul(similar_mul(yearWeight, dy), dy)),
+                similar_mul(similar_mul(lengthWeight, dl), dl)),
+                similar_mul(similar_mul(ratingWeight, dr), dr));
+
+        similar_store(distances + i, distance);
+    }
+#else
+    for (int i = 0; i < SIMILAR_BLOCK; i++)
+    {
+        int p = begin + i;
+
+        distances[i] = similar_score(
+                (float)__builtin_popcountll(index->genres[p] & query->genres),
+                query->tokens + index->tokens[p],
+                index->years[p] - query->fields[0],
+                index->lengths[p] - query->fields[1],
+                index->ratings[p] - query->fields[2]);
+    }
+#endif
+}
+
+/*
+ * How far value is outside low..high, or 0 if inside.
+ */
+static inline float similar_gap(float value, float low, float high)
+{
+    return value < low ? low - value : value > high ? value - high : 0.0f;
+}
+
+/*
+ * No film of the block is nearer to query than this. With the year term
+ * alone it is also a bound for every block further from query's year.
+ */
+static float similar_bound(const SimilarBlock* block, const SimilarQuery* query,
+        int yearOnly)
+{
+    float year = similar_gap(query->fields[0], block->low[0], block->high[0]);
+    float bound = 0.0f + SIMILAR_YEAR * year * year;
+
+    if (!yearOnly)
+    {
+        float length = similar_gap(query->fields[1], block->low[1],
+                block->high[1]);
+        float rating = similar_gap(query->fields[2], block->low[2],
+                block->high[2]);
+
+        bound = bound + SIMILAR_LENGTH * length * length
+                + SIMILAR_RATING * rating * rating;
+    }
+
+    return bound;
+}
+
+/*
+ * Nearest first, and of films as near the one first in the index.
+ */
+static int similar_byNear(const void* a, const void* b)
+{
+    const SimilarNear* x = (const SimilarNear*)a;
+    const SimilarNear* y = (const SimilarNear*)b;
+
+    if (x->distance != y->distance)
+    {
+        return x->distance < y->distance ? -1 : 1;
+    }
+
+    return x->position < y->position ? -1 : x->position > y->position;
+}
+
+/*
+ * Adds the films of block b that beat the worst of the heap.
+ */
+static int similar_merge(const Similar* index, const Film* self, int b, int k,
+        SimilarScratch* heap, int size)
+{
+    int begin = b * SIMILAR_BLOCK;
+    int end = begin + SIMILAR_BLOCK < index->count
+            ? begin + SIMILAR_BLOCK : index->count;
+
+    for (int p = begin; p < end; p++)
+    {
+        float distance = heap->block[p - begin];
+
+        if (index->films[p] == self)
+        {
+            continue;
+        }
+
+        if (size < k)
+        {
+            heap->near[size].distance = distance;
+            heap->near[size++].position = p;
+            mvdb_heapUp(heap->near, size, sizeof(SimilarNear), similar_byNear);
+        }
+        else if (distance < heap->near[0].distance
+                || (distance == heap->near[0].distance
+                && p < heap->near[0].position))
+        {
+            heap->near[0].distance = distance;
+            heap->near[0].position = p;
+            mvdb_heapDown(heap->near, size, sizeof(SimilarNear),
+                    similar_byNear);
+        }
+    }
+
+    return size;
+}
+
+static int similar_search(const Similar* index, const SimilarQuery* query,
+        const Film* self, int k, SimilarScratch* heap, SimilarMatch* matches)
+{
+    if (k <= 0 || index->count == 0)
+    {
+        return 0;
+    }
+
+    /* The block holding the first film of query's year or later */
+    int low = 0;
+    int high = index->count;
+
+    while (low < high)
+    {
+        int middle = low + (high - low) / 2;
+
+        if (index->years[middle] < query->fields[0])
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    int right = low / SIMILAR_BLOCK < index->blockCount
+            ? low / SIMILAR_BLOCK : index->blockCount - 1;
+    int left = right - 1;
+    int size = 0;
+
+    while (left >= 0 || right < index->blockCount)
+    {
+        float leftBound = left >= 0
+                ? similar_bound(&index->blocks[left], query, 1) : INFINITY;
+        float rightBound = right < index->blockCount
+                ? similar_bound(&index->blocks[right], query, 1) : INFINITY;
+        int b = leftBound < rightBound ? left-- : right++;
+
+        /* Every block left is further in years than the worst film kept */
+        if (size == k && fminf(leftBound, rightBound) > heap->near[0].distance)
+        {
+            break;
+        }
+
+        if (size == k && similar_bound(&index->blocks[b], query, 0)
+                > heap->near[0].distance)
+        {
+            continue;
+        }
+
+        similar_kernel(index, query, b * SIMILAR_BLOCK, heap->block);
+        size = similar_merge(index, self, b, k, heap, size);
+    }
+
+    mvdb_heapSort(heap->near, size, sizeof(SimilarNear), similar_byNear);
+
+    for (int m = 0; m < size; m++)
+    {
+        matches[m].film = index->films[heap->near[m].position];
+        matches[m].distance = heap->near[m].distance;
+    }
+
+    return size;
+}
+
+static void similar_scratch(SimilarScratch* heap, int k)
+{
+    heap->near = (SimilarNear*)mvdb_alloc(k * sizeof(SimilarNear));
+    heap->block = (float*)mvdb_alloc(SIMILAR_BLOCK * sizeof(float));
+}
+
+static void similar_freeScratch(SimilarScratch* heap)
+{
+    free(heap->near);
+    free(heap->block);
+}
+
+int similar_top(const Similar* index, const Film* film, int k,
+        SimilarMatch* matches)
+{
+    SimilarQuery query;
+    SimilarScratch heap;
+    int found;
+
+    if (k <= 0)
+    {
+        return 0;
+    }
+
+    similar_features(index, NULL, film, &query);
+    similar_scratch(&heap, k);
+    found = similar_search(index, &query, film, k, &heap, matches);
+    similar_freeScratch(&heap);
+
+    return found;
+}
+
+/*
+ * Reads only the index, never the films, so lazily loaded films are safe to
+ * share between workers.
+ */
+static void* similar_worker(void* argument)
+{
+    SimilarWorker* worker = (SimilarWorker*)argument;
+    const Similar* index = worker->index;
+    SimilarScratch heap;
+
+    similar_scratch(&heap, worker->k);
+
+    for (int p = worker->begin; p < worker->end; p++)
+    {
+        SimilarQuery query;
+
+        similar_at(index, p, &query);
+        similar_search(index, &query, index->films[p], worker->k, &heap,
+                worker->matches + (size_t)p * worker->k);
+    }
+
+    similar_freeScratch(&heap);
+
+    return NULL;
+}
+
+SimilarMatch* similar_all(const Similar* index, int k, int threads)
+{
+    if (k < 0)
+    {
+        k = 0;
+    }
+
+    SimilarMatch* matches = (SimilarMatch*)mvdb_alloc(
+            (size_t)index->count * k * sizeof(SimilarMatch));
+
+    if (threads < 1 || index->count < SIMILAR_PARALLEL_MIN)
+    {
+        threads = 1;
+    }
+
+    SimilarWorker* workers = (SimilarWorker*)mvdb_alloc(
+            threads * sizeof(SimilarWorker));
+
+    for (int t = 0; t < threads; t++)
+    {
+        workers[t].index = index;
+        workers[t].k = k;
+        workers[t].begin = (int)((long)index->count * t / threads);
+        workers[t].end = (int)((long)index->count * (t + 1) / threads);
+        workers[t].matches = matches;
+
+        if (threads == 1)
+        {
+            similar_worker(&workers[t]);
+        }
+        else
+        {
+            pthread_create(&workers[t].thread, NULL, similar_worker,
+                    &workers[t]);
+        }
+    }
+
+    for (int t = 0; t < threads && threads > 1; t++)
+    {
+        pthread_join(workers[t].thread, NULL);
+    }
+
+    free(workers);
+
+    return matches;
+}
+
+size_t similar_bytes(const Similar* index)
+{
+    size_t size = (size_t)index->blockCount * SIMILAR_BLOCK;
+
+    return sizeof(Similar) + size * (sizeof(Film*) + sizeof(uint64_t)
+            + 4 * sizeof(float))
+            + index->blockCount * sizeof(SimilarBlock);
+}
+
+void similar_free(Similar* index)
+{
+    free(index->films);
+    free(index->genres);
+    free(index->tokens);
+    free(index->years);
+    free(index->lengths);
+    free(index->ratings);
+    free(index->blocks);
+    free(index);
+}
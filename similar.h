@@ -0,0 +1,207 @@
+/*
+ * File         : similar.h
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Header file that defines an index for finding the films most
+ *                like a given film. Each film is kept as a small feature
+ *                vector: a bitset of its genre tokens, and its year, run time
+ *                and review rating scaled to 0..1 over the indexed films.
+ *                Distance between two films is
+ *
+ *                    SIMILAR_GENRE  * (1 - 2 |a & b| / (|a| + |b|))
+ *                  + SIMILAR_YEAR   * (year difference)^2
+ *                  + SIMILAR_LENGTH * (run time difference)^2
+ *                  + SIMILAR_RATING * (review rating difference)^2
+ *
+ *                where |a & b| is the number of genre tokens the films share,
+ *                so 0 is the same film and smaller is more alike.
+ *
+ *                Features are stored a field at a time in contiguous arrays,
+ *                sorted by year, so the distance kernel reads 4 films per
+ *                SSE2 step or 8 per AVX2 step. The films are searched in
+ *                blocks of SIMILAR_BLOCK; a block whose years, run times and
+ *                ratings are all too far from the query to beat the k films
+ *                already found is skipped without being read. Blocks are
+ *                searched outwards from the query's year, so the nearest
+ *                films are usually found first and most blocks are skipped.
+ *
+ *                The kernel is chosen when compiled, as in match.c: AVX2,
+ *                else SSE2, else with -DSIMILAR_SCALAR or neither, a film at
+ *                a time. All give the same distances as similar_distance.
+ *
+ *                The index is a snapshot of the list: films added, removed
+ *                or changed afterwards are not seen until it is rebuilt.
+ *
+ * History      : 19/10/2026 v1.00
+ */
+
+#ifndef SIMILAR_H
+#define SIMILAR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "film.h"
+#include "moviedatabase.h"
+
+#define SIMILAR_GENRE 1.0f
+#define SIMILAR_YEAR 1.0f
+#define SIMILAR_LENGTH 0.5f
+#define SIMILAR_RATING 1.0f
+
+/*
+ * Films per block of the search. Each block keeps the range of each numeric
+ * field, for the test that skips it.
+ */
+#define SIMILAR_BLOCK 256
+
+/*
+ * Genre tokens get a bit each, in the order they are first seen. Past
+ * SIMILAR_TOKENS distinct tokens, later ones are counted in |a| but get no
+ * bit, so two films are never seen to share them.
+ */
+#define SIMILAR_TOKENS 64
+
+/*
+ * Batches smaller than this are searched on a single thread.
+ */
+#define SIMILAR_PARALLEL_MIN 4096
+
+typedef struct _SimilarBlock
+{
+    float low[3];
+    float high[3];
+}SimilarBlock;
+
+typedef struct _Similar
+{
+    int count;
+    Film** films;
+    uint64_t* genres;
+    float* tokens;
+    float* years;
+    float* lengths;
+    float* ratings;
+    SimilarBlock* blocks;
+    int blockCount;
+    float low[3];
+    float scale[3];
+    char names[SIMILAR_TOKENS][100];
+    int nameCount;
+}Similar;
+
+/*
+ * A film found, and its distance from the film searched for.
+ */
+typedef struct _SimilarMatch
+{
+    Film* film;
+    float distance;
+}SimilarMatch;
+
+/*******************************************************************************
+
+Procedure   : similar_new
+
+Parameters  : List* list - a linked list of Film structs
+
+Returns     : Similar* - an index of the films now in list
+
+Description : Reads every film once, O(n log n) for the sort by year.
+
+ ******************************************************************************/
+Similar* similar_new(List* list);
+
+/*******************************************************************************
+
+Procedure   : similar_distance
+
+Parameters  : const Similar* index - index from similar_new
+              const Film* a, const Film* b - any two films
+
+Returns     : float - the distance between a and b, with fields scaled as
+                      the index scales them
+
+Description : The plain formula, one pair at a time, as a check on
+              similar_top.
+
+ ******************************************************************************/
+float similar_distance(const Similar* index, const Film* a, const Film* b);
+
+/*******************************************************************************
+
+Procedure   : similar_top
+
+Parameters  : const Similar* index - index from similar_new
+              const Film* film - film to find the likes of; need not be in
+                                 the index
+              int k - number of films wanted
+              SimilarMatch* matches - filled with up to k films, nearest first
+
+Returns     : int - number of matches filled: k, or fewer if the index holds
+                    fewer other films
+
+Description : film itself is never among the matches. Films at equal
+              distance are taken in index order (by year).
+
+ ******************************************************************************/
+int similar_top(const Similar* index, const Film* film, int k,
+        SimilarMatch* matches);
+
+/*******************************************************************************
+
+Procedure   : similar_all
+
+Parameters  : const Similar* index - index from similar_new
+              int k - number of films wanted for each film
+              int threads - most threads to search with
+
+Returns     : SimilarMatch* - k matches for each film of the index: row i,
+                              matches[i * k] to matches[i * k + k - 1], is
+                              for index->films[i]. Rows with fewer than k
+                              matches end with NULL films.
+
+Description : Runs similar_top for every indexed film, the rows split between
+              threads. Must be freed with free().
+
+ ******************************************************************************/
+SimilarMatch* similar_all(const Similar* index, int k, int threads);
+
+/*******************************************************************************
+
+Procedure   : similar_bytes
+
+Parameters  : const Similar* index - index from similar_new
+
+Returns     : size_t - bytes allocated for the index and its feature arrays
+
+Description : For adding an index to ListMemory.indexes.
+
+ ******************************************************************************/
+size_t similar_bytes(const Similar* index);
+
+/*******************************************************************************
+
+Procedure   : similar_free
+
+Parameters  : Similar* index - index from similar_new
+
+Returns     : void
+
+Description : Frees the index, but not the films.
+
+ ******************************************************************************/
+void similar_free(Similar* index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIMILAR_H */
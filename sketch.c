@@ -0,0 +1,507 @@
+/*
+ * File         : sketch.c
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Source file that implements the sketches described in
+ *                sketch.h.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - sketch_bytes.
+ *                19/10/2026 v1.20 - Memory allocated through mvdb.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "sketch.h"
+#include "mvdb.h"
+
+/*
+ * Smallest capacity of a KLL level, however far below the top it is.
+ */
+#define SKETCH_KLL_MIN 8
+
+/*
+ * KLL: level h is a buffer of values that each stand for 2^h added values.
+ * When a level fills it is sorted and every other value, starting at a
+ * random one of the first two, moves up a level. Capacities shrink by 2/3 a
+ * level going down from SKETCH_KLL_K at the top, so the sketch holds about
+ * 3 * SKETCH_KLL_K values however many are added.
+ */
+static void kll_heighten(SketchKll* kll, int height)
+{
+    double capacity = SKETCH_KLL_K;
+
+    kll->height = height;
+
+    for (int h = height - 1; h >= 0; h--)
+    {
+        kll->capacities[h] = capacity < SKETCH_KLL_MIN ? SKETCH_KLL_MIN
+                : (int)ceil(capacity);
+        capacity *= 2.0 / 3.0;
+    }
+}
+
+static void kll_push(SketchKll* kll, int h, float value)
+{
+    if (kll->sizes[h] == kll->allocated[h])
+    {
+        kll->allocated[h] = kll->allocated[h] == 0 ? SKETCH_KLL_MIN * 2
+                : kll->allocated[h] * 2;
+        kll->levels[h] = (float*)mvdb_grow(kll->levels[h],
+                kll->allocated[h] * sizeof(float));
+    }
+
+    kll->levels[h][kll->sizes[h]++] = value;
+}
+
+static int kll_order(const void* a, const void* b)
+{
+    float x = *(const float*)a;
+    float y = *(const float*)b;
+
+    return (x > y) - (x < y);
+}
+
+static unsigned int kll_random(SketchKll* kll)
+{
+    kll->seed ^= kll->seed << 13;
+    kll->seed ^= kll->seed >> 17;
+    kll->seed ^= kll->seed << 5;
+
+    return kll->seed;
+}
+
+static void kll_compact(SketchKll* kll, int h)
+{
+    float* values = kll->levels[h];
+    int size = kll->sizes[h];
+    int odd = size & 1;
+
+    if (h + 1 == kll->height)
+    {
+        kll_heighten(kll, kll->height + 1);
+    }
+
+    qsort(values, size, sizeof(float), kll_order);
+
+    /* With an odd number the smallest value stays behind on its own */
+    for (int i = odd + (kll_random(kll) & 1); i < size; i += 2)
+    {
+        kll_push(kll, h + 1, values[i]);
+    }
+
+    kll->sizes[h] = odd;
+}
+
+/*
+ * A compaction empties its level, so one pass upwards leaves every level
+ * within its capacity.
+ */
+static void kll_compress(SketchKll* kll)
+{
+    for (int h = 0; h < kll->height && h + 1 < SKETCH_KLL_LEVELS; h++)
+    {
+        if (kll->sizes[h] >= kll->capacities[h])
+        {
+            kll_compact(kll, h);
+        }
+    }
+}
+
+static void kll_range(SketchKll* kll, float min, float max)
+{
+    if (kll->count == 0 || min < kll->min)
+    {
+        kll->min = min;
+    }
+    if (kll->count == 0 || max > kll->max)
+    {
+        kll->max = max;
+    }
+}
+
+static void kll_add(SketchKll* kll, float value)
+{
+    kll_range(kll, value, value);
+    kll->count++;
+    kll_push(kll, 0, value);
+
+    if (kll->sizes[0] >= kll->capacities[0])
+    {
+        kll_compress(kll);
+    }
+}
+
+static void kll_merge(SketchKll* into, const SketchKll* from)
+{
+    if (from->count == 0)
+    {
+        return;
+    }
+
+    kll_range(into, from->min, from->max);
+    into->count += from->count;
+
+    if (from->height > into->height)
+    {
+        kll_heighten(into, from->height);
+    }
+
+    for (int h = 0; h < from->height; h++)
+    {
+        for (int i = 0; i < from->sizes[h]; i++)
+        {
+            kll_push(into, h, from->levels[h][i]);
+        }
+    }
+
+    kll_compress(into);
+}
+
+typedef struct _SketchWeighted
+{
+    float value;
+    double weight;
+}SketchWeighted;
+
+static int kll_weightedOrder(const void* a, const void* b)
+{
+    return kll_order(&((const SketchWeighted*)a)->value,
+            &((const SketchWeighted*)b)->value);
+}
+
+static double kll_quantile(const SketchKll* kll, double q)
+{
+    if (kll->count == 0)
+    {
+        return 0;
+    }
+    if (q <= 0)
+    {
+        return kll->min;
+    }
+    if (q >= 1)
+    {
+        return kll->max;
+    }
+
+    int held = 0;
+
+    for (int h = 0; h < kll->height; h++)
+    {
+        held += kll->sizes[h];
+    }
+
+    SketchWeighted* values = (SketchWeighted*)mvdb_grow(NULL,
+            held * sizeof(SketchWeighted));
+    double total = 0;
+    int n = 0;
+
+    for (int h = 0; h < kll->height; h++)
+    {
+        for (int i = 0; i < kll->sizes[h]; i++)
+        {
+            values[n].value = kll->levels[h][i];
+            values[n++].weight = ldexp(1.0, h);
+        }
+
+        total += ldexp(kll->sizes[h], h);
+    }
+
+    qsort(values, n, sizeof(SketchWeighted), kll_weightedOrder);
+
+    double seen = 0;
+    double answer = kll->max;
+
+    for (int i = 0; i < n; i++)
+    {
+        seen += values[i].weight;
+
+        if (seen >= q * total)
+        {
+            answer = values[i].value;
+            break;
+        }
+    }
+
+    free(values);
+
+    return answer;
+}
+
+static void kll_free(SketchKll* kll)
+{
+    for (int h = 0; h < SKETCH_KLL_LEVELS; h++)
+    {
+        free(kll->levels[h]);
+    }
+}
+
+/*
+ * HyperLogLog over a 64 bit hash of the bytes: the top bits choose a
+ * register, which keeps the longest run of leading zeros seen in the rest.
+ */
+static unsigned long long hll_hash(const char* text, size_t length)
+{
+    unsigned long long hash = 14695981039346656037ull;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)text[i];
+        hash *= 1099511628211ull;
+    }
+
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+static void hll_add(SketchHll* hll, const char* text, size_t length)
+{
+    unsigned long long hash = hll_hash(text, length);
+    int index = (int)(hash >> (64 - SKETCH_HLL_BITS));
+    unsigned long long rest = (hash << SKETCH_HLL_BITS)
+            | (1ull << (SKETCH_HLL_BITS - 1));
+    unsigned char rank = (unsigned char)(__builtin_clzll(rest) + 1);
+
+    if (rank > hll->registers[index])
+    {
+        hll->registers[index] = rank;
+    }
+}
+
+static void hll_merge(SketchHll* into, const SketchHll* from)
+{
+    for (int i = 0; i < SKETCH_HLL_REGISTERS; i++)
+    {
+        if (from->registers[i] > into->registers[i])
+        {
+            into->registers[i] = from->registers[i];
+        }
+    }
+}
+
+static double hll_estimate(const SketchHll* hll)
+{
+    double m = SKETCH_HLL_REGISTERS;
+    double sum = 0;
+    int zeros = 0;
+
+    for (int i = 0; i < SKETCH_HLL_REGISTERS; i++)
+    {
+        sum += ldexp(1.0, -hll->registers[i]);
+        zeros += hll->registers[i] == 0;
+    }
+
+    double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+
+    if (estimate <= 2.5 * m && zeros > 0)
+    {
+        estimate = m * log(m / zeros);
+    }
+
+    return estimate;
+}
+
+static int sketch_bin(int value, int first, int width, int bins)
+{
+    int bin = (value - first) / width;
+
+    if (value < first)
+    {
+        return 0;
+    }
+
+    return bin >= bins ? bins - 1 : bin;
+}
+
+static void sketch_reset(Sketch* sketch)
+{
+    Journal* journal = sketch->journal;
+
+    kll_free(&sketch->reviewRatings);
+    kll_free(&sketch->lengths);
+    memset(sketch, 0, sizeof(Sketch));
+
+    sketch->journal = journal;
+    kll_heighten(&sketch->reviewRatings, 1);
+    kll_heighten(&sketch->lengths, 1);
+    sketch->reviewRatings.seed = 2463534242u;
+    sketch->lengths.seed = 88675123u;
+}
+
+void sketch_add(Sketch* sketch, const Film* film)
+{
+    const char* genre = film_getGenre(film);
+    const char* title = film_getTitle(film);
+
+    sketch->films++;
+    kll_add(&sketch->reviewRatings, film_getReviewRating(film));
+    kll_add(&sketch->lengths, film_getLength(film));
+    hll_add(&sketch->titles, title, strlen(title));
+
+    while (*genre != '\0')
+    {
+        size_t length = strcspn(genre, "/");
+
+        hll_add(&sketch->genres, genre, length);
+        genre += length + (genre[length] == '/');
+    }
+
+    sketch->years[sketch_bin(film_getYear(film), SKETCH_YEAR_FIRST, 1,
+            SKETCH_YEARS)]++;
+    sketch->lengthBins[sketch_bin(film_getLength(film), 0,
+            SKETCH_LENGTH_WIDTH, SKETCH_LENGTHS)]++;
+}
+
+static void sketch_listener(void* context, const JournalEntry* entry)
+{
+    Sketch* sketch = (Sketch*)context;
+
+    switch (entry->op)
+    {
+        case JOURNAL_INSERT:
+            sketch_add(sketch, entry->film);
+            break;
+
+        case JOURNAL_CLEAR:
+            sketch_reset(sketch);
+            break;
+
+        default:
+            break;
+    }
+}
+
+Sketch* sketch_new(List* list)
+{
+    Sketch* sketch = (Sketch*)mvdb_alloc(sizeof(Sketch));
+
+    sketch_reset(sketch);
+
+    if (list != NULL)
+    {
+        for (Iterator i = list_begin(list); i != list_end(list);
+                i = iterator_next(i))
+        {
+            sketch_add(sketch, iterator_value(i));
+        }
+
+        sketch->journal = list_journal(list);
+        journal_listen(sketch->journal, sketch_listener, sketch);
+    }
+
+    return sketch;
+}
+
+void sketch_merge(Sketch* into, const Sketch* from)
+{
+    into->films += from->films;
+    kll_merge(&into->reviewRatings, &from->reviewRatings);
+    kll_merge(&into->lengths, &from->lengths);
+    hll_merge(&into->titles, &from->titles);
+    hll_merge(&into->genres, &from->genres);
+
+    for (int b = 0; b < SKETCH_YEARS; b++)
+    {
+        into->years[b] += from->years[b];
+    }
+
+    for (int b = 0; b < SKETCH_LENGTHS; b++)
+    {
+        into->lengthBins[b] += from->lengthBins[b];
+    }
+}
+
+double sketch_quantile(const Sketch* sketch, FilmField field, double q)
+{
+    return kll_quantile(field == FILM_LENGTH ? &sketch->lengths
+            : &sketch->reviewRatings, q);
+}
+
+double sketch_distinct(const Sketch* sketch, FilmField field)
+{
+    return hll_estimate(field == FILM_GENRE ? &sketch->genres
+            : &sketch->titles);
+}
+
+void sketch_print(const Sketch* sketch)
+{
+    FilmField fields[] = { FILM_REVIEWRATING, FILM_LENGTH };
+    const char* names[] = { "review rating", "run time" };
+
+    printf("\nFilms sketched: %ld, about %.0f distinct titles and %.0f "
+            "distinct genres\n", sketch->films,
+            sketch_distinct(sketch, FILM_TITLE),
+            sketch_distinct(sketch, FILM_GENRE));
+    printf("  %-14s %8s %8s %8s %8s %8s %8s\n", "", "min", "p25", "median",
+            "p75", "p90", "max");
+
+    for (int f = 0; f < 2; f++)
+    {
+        printf("  %-14s %8.1f %8.1f %8.1f %8.1f %8.1f %8.1f\n", names[f],
+                sketch_quantile(sketch, fields[f], 0),
+                sketch_quantile(sketch, fields[f], 0.25),
+                sketch_quantile(sketch, fields[f], 0.5),
+                sketch_quantile(sketch, fields[f], 0.75),
+                sketch_quantile(sketch, fields[f], 0.9),
+                sketch_quantile(sketch, fields[f], 1));
+    }
+
+    printf("  films by decade:\n");
+
+    for (int decade = 0; decade < SKETCH_YEARS; decade += 10)
+    {
+        long films = 0;
+
+        for (int b = decade; b < decade + 10 && b < SKETCH_YEARS; b++)
+        {
+            films += sketch->years[b];
+        }
+
+        if (films > 0)
+        {
+            printf("    %ds %8ld\n", SKETCH_YEAR_FIRST + decade, films);
+        }
+    }
+}
+
+void sketch_free(Sketch* sketch)
+{
+    if (sketch->journal != NULL)
+    {
+        journal_unlisten(sketch->journal, sketch_listener, sketch);
+    }
+
+    kll_free(&sketch->reviewRatings);
+    kll_free(&sketch->lengths);
+    free(sketch);
+}
+
+static size_t kll_bytes(const SketchKll* kll)
+{
+    size_t bytes = 0;
+
+    for (int h = 0; h < SKETCH_KLL_LEVELS; h++)
+    {
+        bytes += kll->allocated[h] * sizeof(float);
+    }
+
+    return bytes;
+}
+
+size_t sketch_bytes(const Sketch* sketch)
+{
+    return sizeof(Sketch) + kll_bytes(&sketch->reviewRatings)
+            + kll_bytes(&sketch->lengths);
+}
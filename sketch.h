@@ -0,0 +1,224 @@
+/*
+ * File         : sketch.h
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Header file that defines small, fixed size summaries of the
+ *                whole collection, so dashboard figures can be read without
+ *                sorting or even walking the list:
+ *                  quantiles   - review rating and run time, each in a KLL
+ *                                sketch (about 1% rank error)
+ *                  distinct    - titles and "/" separated genre tokens, each
+ *                                in a HyperLogLog (about 1.6% error)
+ *                  histograms  - exact counts by year and by ten minutes of
+ *                                run time
+ *
+ *                A sketch made from a list follows the list's change journal
+ *                and takes in every film added after it. Two sketches of
+ *                different films can be merged, so threads loading parts of
+ *                a collection can each keep their own and combine them at
+ *                the end.
+ *
+ *                Sketches only ever take films in. A film deleted from the
+ *                list, or changed through a film_set method, is still
+ *                counted as it was when added; clearing the list empties
+ *                the sketch.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - sketch_bytes.
+ */
+
+#ifndef SKETCH_H
+#define SKETCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "film.h"
+#include "moviedatabase.h"
+
+/*
+ * Size of the largest KLL level. Rank error is roughly 1.7 / SKETCH_KLL_K.
+ */
+#define SKETCH_KLL_K 200
+#define SKETCH_KLL_LEVELS 40
+
+/*
+ * HyperLogLog registers are indexed by the top SKETCH_HLL_BITS of the hash.
+ * Standard error is 1.04 / sqrt(1 << SKETCH_HLL_BITS).
+ */
+#define SKETCH_HLL_BITS 12
+#define SKETCH_HLL_REGISTERS (1 << SKETCH_HLL_BITS)
+
+/*
+ * Histogram bins. Years and run times outside the range are counted in the
+ * first or last bin.
+ */
+#define SKETCH_YEAR_FIRST 1880
+#define SKETCH_YEARS 160
+#define SKETCH_LENGTH_WIDTH 10
+#define SKETCH_LENGTHS 40
+
+/*
+ * Level h holds values that each stand for 2^h of the values added.
+ */
+typedef struct _SketchKll
+{
+    float* levels[SKETCH_KLL_LEVELS];
+    int sizes[SKETCH_KLL_LEVELS];
+    int allocated[SKETCH_KLL_LEVELS];
+    int capacities[SKETCH_KLL_LEVELS];
+    int height;
+    long count;
+    float min;
+    float max;
+    unsigned int seed;
+}SketchKll;
+
+typedef struct _SketchHll
+{
+    unsigned char registers[SKETCH_HLL_REGISTERS];
+}SketchHll;
+
+typedef struct _Sketch
+{
+    Journal* journal;
+    long films;
+    SketchKll reviewRatings;
+    SketchKll lengths;
+    SketchHll titles;
+    SketchHll genres;
+    long years[SKETCH_YEARS];
+    long lengthBins[SKETCH_LENGTHS];
+}Sketch;
+
+/*******************************************************************************
+
+Procedure   : sketch_new
+
+Parameters  : List* list - a filled linked list of Film structs, or NULL
+
+Returns     : Sketch* - a sketch of the films now in the list, or an empty
+                        sketch if list is NULL
+
+Description : Adds every film in the list, then registers with
+              list_journal(list) so every film added to the list later is
+              added to the sketch as well. An empty sketch is filled with
+              sketch_add.
+
+ ******************************************************************************/
+Sketch* sketch_new(List* list);
+
+/*******************************************************************************
+
+Procedure   : sketch_add
+
+Parameters  : Sketch* sketch - sketch from sketch_new
+              const Film* film - film to count
+
+Returns     : void
+
+Description : Counts film in every summary. Amortised constant time.
+
+ ******************************************************************************/
+void sketch_add(Sketch* sketch, const Film* film);
+
+/*******************************************************************************
+
+Procedure   : sketch_merge
+
+Parameters  : Sketch* into - sketch to add to
+              const Sketch* from - sketch of other films, left unchanged
+
+Returns     : void
+
+Description : Makes into a sketch of the films of both, with the same error
+              bounds as if every film had been added to into.
+
+ ******************************************************************************/
+void sketch_merge(Sketch* into, const Sketch* from);
+
+/*******************************************************************************
+
+Procedure   : sketch_quantile
+
+Parameters  : const Sketch* sketch - sketch from sketch_new
+              FilmField field - FILM_REVIEWRATING or FILM_LENGTH
+              double q - fraction of films at or below the answer, 0 to 1
+
+Returns     : double - the approximate q quantile of field, such as the
+                       median for 0.5, or 0 if the sketch is empty
+
+Description : Sorts the few hundred values the sketch keeps, so answers in
+              microseconds whatever the number of films.
+
+ ******************************************************************************/
+double sketch_quantile(const Sketch* sketch, FilmField field, double q);
+
+/*******************************************************************************
+
+Procedure   : sketch_distinct
+
+Parameters  : const Sketch* sketch - sketch from sketch_new
+              FilmField field - FILM_TITLE or FILM_GENRE
+
+Returns     : double - the estimated number of distinct titles, or of
+                       distinct genre tokens
+
+Description : HyperLogLog estimate, with the linear counting correction for
+              small counts.
+
+ ******************************************************************************/
+double sketch_distinct(const Sketch* sketch, FilmField field);
+
+/*******************************************************************************
+
+Procedure   : sketch_print
+
+Parameters  : const Sketch* sketch - sketch from sketch_new
+
+Returns     : void
+
+Description : Prints the dashboard figures: film count, distinct titles and
+              genres, quartiles and p90 of review rating and run time, and
+              the year histogram by decade.
+
+ ******************************************************************************/
+void sketch_print(const Sketch* sketch);
+
+/*******************************************************************************
+
+Procedure   : sketch_free
+
+Parameters  : Sketch* sketch - sketch from sketch_new
+
+Returns     : void
+
+Description : Stops following the list, if any, and frees the sketch. Must be
+              called before the list is freed.
+
+ ******************************************************************************/
+void sketch_free(Sketch* sketch);
+
+/*******************************************************************************
+
+Procedure   : sketch_bytes
+
+Parameters  : const Sketch* sketch - sketch from sketch_new
+
+Returns     : size_t - bytes allocated for the sketch and its KLL levels
+
+Description : For adding a sketch to ListMemory.indexes. The size stays
+              within a few tens of kilobytes however many films are added.
+
+ ******************************************************************************/
+size_t sketch_bytes(const Sketch* sketch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SKETCH_H */
@@ -0,0 +1,567 @@
+/*
+ * File         : stream.c
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Source file that implements the streaming report described
+ *                in stream.h using bounded heaps and an external merge sort.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - Input and runs read through parser.h.
+ *                19/10/2026 v1.20 - Memory allocated through mvdb.h.
+ *                19/10/2026 v1.30 - Top-k and run merge kept in the heap of
+ *                                   mvdb.h.
+ *                19/10/2026 v1.40 - Missing films reported as the list
+ *                                   report does.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stream.h"
+#include "film.h"
+#include "parser.h"
+#include "mvdb.h"
+
+/*
+ * A film together with its position in the input, which is what the stable
+ * bubble sorts in main.c fall back on when two films compare equal.
+ */
+typedef struct _StreamEntry
+{
+    Film* film;
+    long seq;
+}StreamEntry;
+
+typedef int (*StreamOrder)(const void*, const void*);
+
+/*
+ * A bounded heap keeping the k entries that rank first. The root is the
+ * entry that ranks last among them, ready to be replaced.
+ */
+typedef struct _StreamHeap
+{
+    StreamEntry* entries;
+    int count;
+    int k;
+    StreamOrder order;
+}StreamHeap;
+
+/*
+ * Sorted runs spilled to temporary files, in input order. level counts how
+ * many merges a run has been through.
+ */
+typedef struct _StreamRuns
+{
+    FILE** files;
+    int* levels;
+    int count;
+    int size;
+    StreamOrder order;
+}StreamRuns;
+
+typedef struct _StreamReader
+{
+    FILE* file;
+    StreamEntry head;
+    StreamOrder order;
+    Parser parser;
+}StreamReader;
+
+typedef void (*StreamEmit)(const Film*, void*);
+
+static long stream_compareLong(long a, long b)
+{
+    return (a > b) - (a < b);
+}
+
+/*
+ * Oldest first, as list_year.
+ */
+static int stream_byYear(const void* a, const void* b)
+{
+    const StreamEntry* x = (const StreamEntry*)a;
+    const StreamEntry* y = (const StreamEntry*)b;
+
+    if (film_getYear(x->film) != film_getYear(y->film))
+    {
+        return film_getYear(x->film) < film_getYear(y->film) ? -1 : 1;
+    }
+
+    return stream_compareLong(x->seq, y->seq);
+}
+
+/*
+ * Longest first, as list_lengthS applied after the chronological sort.
+ */
+static int stream_byLength(const void* a, const void* b)
+{
+    const StreamEntry* x = (const StreamEntry*)a;
+    const StreamEntry* y = (const StreamEntry*)b;
+
+    if (film_getLength(x->film) != film_getLength(y->film))
+    {
+        return film_getLength(x->film) > film_getLength(y->film) ? -1 : 1;
+    }
+
+    return stream_byYear(a, b);
+}
+
+/*
+ * Highest rated first, as list_reviewRating applied after the length sort.
+ */
+static int stream_byReview(const void* a, const void* b)
+{
+    const StreamEntry* x = (const StreamEntry*)a;
+    const StreamEntry* y = (const StreamEntry*)b;
+
+    if (film_getReviewRating(x->film) != film_getReviewRating(y->film))
+    {
+        return film_getReviewRating(x->film) > film_getReviewRating(y->film)
+                ? -1 : 1;
+    }
+
+    return stream_byLength(a, b);
+}
+
+/*
+ * Shortest title first; list_sortTitle keeps the first of equal titles in the
+ * list, which is sorted by review rating at that point.
+ */
+static int stream_byTitle(const void* a, const void* b)
+{
+    const StreamEntry* x = (const StreamEntry*)a;
+    const StreamEntry* y = (const StreamEntry*)b;
+    size_t xLength = strlen(film_getTitle(x->film));
+    size_t yLength = strlen(film_getTitle(y->film));
+
+    if (xLength != yLength)
+    {
+        return xLength < yLength ? -1 : 1;
+    }
+
+    return stream_byReview(a, b);
+}
+
+static Film* stream_copy(const Film* film)
+{
+    return film_new((char*)film_getTitle(film), film_getYear(film),
+            (char*)film_getRating(film), (char*)film_getGenre(film),
+            film_getLength(film), film_getReviewRating(film));
+}
+
+static void heap_init(StreamHeap* heap, int k, StreamOrder order)
+{
+    heap->entries = (StreamEntry*)mvdb_alloc(k * sizeof(StreamEntry));
+    heap->count = 0;
+    heap->k = k;
+    heap->order = order;
+}
+
+/*
+ * Keeps a copy of the entry if it ranks among the best k seen so far. The
+ * film is only copied when it is kept, so most films cost one comparison.
+ */
+static void heap_offer(StreamHeap* heap, const StreamEntry* entry)
+{
+    StreamEntry* entries = heap->entries;
+
+    if (heap->count < heap->k)
+    {
+        int i = heap->count++;
+        entries[i].film = stream_copy(entry->film);
+        entries[i].seq = entry->seq;
+        mvdb_heapUp(entries, heap->count, sizeof(StreamEntry), heap->order);
+    }
+    else if (heap->order(entry, &entries[0]) < 0)
+    {
+        film_free(entries[0].film);
+        entries[0].film = stream_copy(entry->film);
+        entries[0].seq = entry->seq;
+        mvdb_heapDown(entries, heap->count, sizeof(StreamEntry), heap->order);
+    }
+}
+
+/*
+ * Returns the k-th ranked film, or NULL if fewer than k films matched.
+ */
+static Film* heap_kth(StreamHeap* heap)
+{
+    if (heap->count < heap->k)
+    {
+        return NULL;
+    }
+
+    qsort(heap->entries, heap->count, sizeof(StreamEntry), heap->order);
+
+    return heap->entries[heap->k - 1].film;
+}
+
+static void heap_free(StreamHeap* heap)
+{
+    for (int i = 0; i < heap->count; i++)
+    {
+        film_free(heap->entries[i].film);
+    }
+
+    free(heap->entries);
+}
+
+static int reader_advance(StreamReader* reader)
+{
+    if (reader->head.film != NULL)
+    {
+        film_free(reader->head.film);
+        reader->head.film = NULL;
+    }
+
+    FilmRecord record;
+
+    if (!parser_next(&reader->parser, &record))
+    {
+        return 0;
+    }
+
+    reader->head.film = film_fromRecord(&record);
+
+    return 1;
+}
+
+/*
+ * Merge heap order: the reader whose head comes first goes last, so the
+ * heap keeps it at its root.
+ */
+static int reader_later(const void* a, const void* b)
+{
+    const StreamReader* x = *(StreamReader* const*)a;
+    const StreamReader* y = *(StreamReader* const*)b;
+
+    return x->order(&y->head, &x->head);
+}
+
+/*
+ * K-way merge of sorted runs. Each run's position is used as the sequence
+ * number of its films, so equal films come out in input order. The runs are
+ * closed once merged.
+ */
+static void stream_merge(FILE** runs, int count, StreamOrder order,
+        StreamEmit emit, void* context)
+{
+    StreamReader* readers = (StreamReader*)mvdb_alloc(
+            count * sizeof(StreamReader));
+    StreamReader** heap = (StreamReader**)mvdb_alloc(
+            count * sizeof(StreamReader*));
+    int live = 0;
+
+    for (int r = 0; r < count; r++)
+    {
+        memset(&readers[r], 0, sizeof(StreamReader));
+        readers[r].file = runs[r];
+        readers[r].head.seq = r;
+        readers[r].order = order;
+        rewind(runs[r]);
+        parser_init(&readers[r].parser, runs[r], NULL);
+
+        if (reader_advance(&readers[r]))
+        {
+            heap[live++] = &readers[r];
+            mvdb_heapUp(heap, live, sizeof(StreamReader*), reader_later);
+        }
+    }
+
+    while (live > 0)
+    {
+        StreamReader* first = heap[0];
+
+        emit(first->head.film, context);
+
+        if (!reader_advance(first))
+        {
+            heap[0] = heap[--live];
+        }
+
+        mvdb_heapDown(heap, live, sizeof(StreamReader*), reader_later);
+    }
+
+    for (int r = 0; r < count; r++)
+    {
+        parser_free(&readers[r].parser);
+        fclose(readers[r].file);
+    }
+
+    free(readers);
+    free(heap);
+}
+
+static void stream_emitRun(const Film* film, void* context)
+{
+    film_write((FILE*)context, film);
+}
+
+static void stream_emitPrint(const Film* film, void* context)
+{
+    (void)context;
+
+    printf("----------------------------------------------------------\n");
+    film_print((Film*)film);
+}
+
+static FILE* stream_tmpfile()
+{
+    FILE* run = tmpfile();
+
+    if (run == NULL)
+    {
+        perror("Error: unable to create a temporary run file");
+    }
+
+    return run;
+}
+
+/*
+ * Merges runs [first, first + count) into a single run in their place.
+ */
+static int runs_collapse(StreamRuns* runs, int first, int count)
+{
+    FILE* merged = stream_tmpfile();
+
+    if (merged == NULL)
+    {
+        return 0;
+    }
+
+    int level = runs->levels[first + count - 1] + 1;
+
+    stream_merge(runs->files + first, count, runs->order, stream_emitRun,
+            merged);
+
+    runs->files[first] = merged;
+    runs->levels[first] = level;
+    memmove(runs->files + first + 1, runs->files + first + count,
+            (runs->count - first - count) * sizeof(FILE*));
+    memmove(runs->levels + first + 1, runs->levels + first + count,
+            (runs->count - first - count) * sizeof(int));
+    runs->count -= count - 1;
+
+    return 1;
+}
+
+/*
+ * Sorts a batch and writes it out as a new run. Whenever the last
+ * STREAM_FANIN runs share a level they are merged into one run a level up,
+ * so the number of open runs only grows with the log of the input size.
+ */
+static int runs_spill(StreamRuns* runs, StreamEntry* batch, int count)
+{
+    if (count == 0)
+    {
+        return 1;
+    }
+
+    FILE* run = stream_tmpfile();
+
+    if (run == NULL)
+    {
+        return 0;
+    }
+
+    qsort(batch, count, sizeof(StreamEntry), runs->order);
+
+    for (int i = 0; i < count; i++)
+    {
+        film_write(run, batch[i].film);
+    }
+
+    if (runs->count == runs->size)
+    {
+        runs->size = runs->size == 0 ? STREAM_FANIN : runs->size * 2;
+        runs->files = (FILE**)mvdb_grow(runs->files,
+                runs->size * sizeof(FILE*));
+        runs->levels = (int*)mvdb_grow(runs->levels, runs->size * sizeof(int));
+    }
+
+    runs->files[runs->count] = run;
+    runs->levels[runs->count++] = 0;
+
+    while (runs->count >= STREAM_FANIN)
+    {
+        int first = runs->count - STREAM_FANIN;
+
+        if (runs->levels[first] != runs->levels[runs->count - 1])
+        {
+            break;
+        }
+        if (!runs_collapse(runs, first, STREAM_FANIN))
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/*
+ * Prints every film held in the runs in list_printAll's format.
+ */
+static int runs_print(StreamRuns* runs)
+{
+    while (runs->count > STREAM_FANIN)
+    {
+        if (!runs_collapse(runs, runs->count - STREAM_FANIN, STREAM_FANIN))
+        {
+            return 0;
+        }
+    }
+
+    printf("\n");
+    printf("*********************************************************\n");
+    stream_merge(runs->files, runs->count, runs->order, stream_emitPrint,
+            NULL);
+    printf("*********************************************************\n");
+
+    runs->count = 0;
+    free(runs->files);
+    free(runs->levels);
+
+    return 1;
+}
+
+/*
+ * Prints the k-th film of heap in list_printSelect's format.
+ */
+static void stream_printSelect(StreamHeap* heap)
+{
+    printf("\n");
+
+    printf("*********************************************************\n");
+
+    film_printFound(heap_kth(heap), heap->k);
+
+    printf("*********************************************************\n");
+}
+
+int stream_report(FILE* input, int batchSize, FILE* rejects)
+{
+    StreamRuns chronological = { NULL, NULL, 0, 0, stream_byYear };
+    StreamRuns remaining = { NULL, NULL, 0, 0, stream_byReview };
+    StreamHeap filmNoir, sciFi, highest, shortest;
+
+    if (batchSize < 1)
+    {
+        batchSize = STREAM_BATCH;
+    }
+
+    heap_init(&filmNoir, 3, stream_byLength);
+    heap_init(&sciFi, 10, stream_byReview);
+    heap_init(&highest, 1, stream_byReview);
+    heap_init(&shortest, 1, stream_byTitle);
+
+    /* Non-R films are shared with the chronological batch, not copied */
+    StreamEntry* batch = (StreamEntry*)mvdb_alloc(
+            batchSize * sizeof(StreamEntry));
+    StreamEntry* kept = (StreamEntry*)mvdb_alloc(
+            batchSize * sizeof(StreamEntry));
+    int batchCount = 0;
+    int keptCount = 0;
+    long seq = 0;
+    int ok = 1;
+
+    Parser parser;
+    FilmRecord record;
+
+    parser_init(&parser, input, rejects);
+
+    while (ok && parser_next(&parser, &record))
+    {
+        StreamEntry entry = { film_fromRecord(&record), seq++ };
+
+        if (film_hasGenre(entry.film, "Film-Noir"))
+        {
+            heap_offer(&filmNoir, &entry);
+        }
+        if (film_hasGenre(entry.film, "Sci-Fi"))
+        {
+            heap_offer(&sciFi, &entry);
+        }
+
+        heap_offer(&highest, &entry);
+        heap_offer(&shortest, &entry);
+
+        batch[batchCount++] = entry;
+
+        if (!film_isRRated(entry.film))
+        {
+            kept[keptCount++] = entry;
+        }
+
+        if (batchCount == batchSize)
+        {
+            ok = runs_spill(&chronological, batch, batchCount)
+                    && runs_spill(&remaining, kept, keptCount);
+
+            for (int i = 0; i < batchCount; i++)
+            {
+                film_free(batch[i].film);
+            }
+
+            batchCount = keptCount = 0;
+        }
+    }
+
+    ok = ok && runs_spill(&chronological, batch, batchCount)
+            && runs_spill(&remaining, kept, keptCount);
+
+    for (int i = 0; i < batchCount; i++)
+    {
+        film_free(batch[i].film);
+    }
+
+    parser_free(&parser);
+    free(batch);
+    free(kept);
+
+    if (ok)
+    {
+        printf("Films successfully streamed through MVDB: %ld", seq);
+
+        if (parser.rejected > 0)
+        {
+            printf(" (%ld rows rejected)", parser.rejected);
+        }
+
+        printf("\nOffline MVDB in Chronological Order (oldest to newest):");
+        ok = runs_print(&chronological);
+    }
+
+    if (ok)
+    {
+        printf("\nThe Third Longest Film-Noir film is: ");
+        stream_printSelect(&filmNoir);
+
+        printf("\nThe Tenth Highest Rated Sci-Fi Film is: ");
+        stream_printSelect(&sciFi);
+
+        printf("\nThe Highest Rated Film is: ");
+        stream_printSelect(&highest);
+
+        printf("\nThe Film with the Shortest Title is:");
+        printf("\n");
+
+        if (heap_kth(&shortest) != NULL)
+        {
+            film_print(heap_kth(&shortest));
+        }
+
+        ok = runs_print(&remaining);
+    }
+
+    heap_free(&filmNoir);
+    heap_free(&sciFi);
+    heap_free(&highest);
+    heap_free(&shortest);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
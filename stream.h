@@ -0,0 +1,65 @@
+/*
+ * File         : stream.h
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Header file that defines a streaming version of the report in
+ *                main.c. Films are read in fixed size batches and never all
+ *                held in memory at once, so catalogues larger than the
+ *                available RAM can be processed in a fixed memory budget.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - Rejected rows are reported.
+ */
+
+#ifndef STREAM_H
+#define STREAM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+
+/*
+ * Number of films held in memory per batch when none is given.
+ */
+#define STREAM_BATCH 4096
+
+/*
+ * Most sorted runs merged at once. Anything above this is merged in several
+ * passes so the number of open temporary files stays bounded.
+ */
+#define STREAM_FANIN 64
+
+/*******************************************************************************
+
+Procedure   : stream_report
+
+Parameters  : FILE* input - an open films.txt style file
+              int batchSize - number of films held in memory per batch
+              FILE* rejects - file that rows which are not valid films are 
+                              reported to, or NULL to drop them
+
+Returns     : int - EXIT_SUCCESS, or EXIT_FAILURE if a temporary file could
+                    not be created
+
+Description : Produces the same report as main.c while the file streams past.
+              The k-th longest Film-Noir, k-th highest rated Sci-Fi, highest
+              rated and shortest title films are kept in bounded heaps. The
+              chronological listing and the listing left after deleting "R"
+              films are sorted one batch at a time into runs spilled to
+              temporary files, then printed by an external merge of the runs.
+              Ties are broken the same way as the repeated stable sorts in
+              main.c, so both reports print films in the same order.
+
+ ******************************************************************************/
+int stream_report(FILE* input, int batchSize, FILE* rejects);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STREAM_H */
@@ -0,0 +1,462 @@
+/*
+ * File         : view.c
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Source file that implements the materialized views described
+ *                in view.h.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - view_bytes.
+ *                19/10/2026 v1.20 - Memory allocated through mvdb.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "view.h"
+#include "mvdb.h"
+
+/*
+ * Sort key of a film in this view; smaller keys come first.
+ */
+static double view_key(const View* view, const Film* film)
+{
+    switch (view->order)
+    {
+        case VIEW_LONGEST:
+            return -film_getLength(film);
+        case VIEW_HIGHEST_RATED:
+            return -film_getReviewRating(film);
+        default:
+            return strlen(film_getTitle(film));
+    }
+}
+
+static int view_holds(const View* view, const Film* film)
+{
+    return view->genre[0] == '\0' || film_hasGenre(film, view->genre);
+}
+
+static int view_affects(const View* view, FilmField field)
+{
+    switch (field)
+    {
+        case FILM_LENGTH:
+            return view->order == VIEW_LONGEST;
+        case FILM_REVIEWRATING:
+            return view->order == VIEW_HIGHEST_RATED;
+        case FILM_TITLE:
+            return view->order == VIEW_SHORTEST_TITLE;
+        case FILM_GENRE:
+            return view->genre[0] != '\0';
+        default:
+            return 0;
+    }
+}
+
+/*
+ * Film to node table: open addressing with linear probing on the film's
+ * address.
+ */
+static size_t view_hash(const View* view, const Film* film)
+{
+    unsigned long long bits = (unsigned long long)(size_t)film;
+
+    bits ^= bits >> 33;
+    bits *= 0xff51afd7ed558ccdull;
+    bits ^= bits >> 33;
+
+    return (size_t)bits & view->mask;
+}
+
+static size_t view_slot(const View* view, const Film* film)
+{
+    size_t i = view_hash(view, film);
+
+    while (view->slots[i] != NULL && view->slots[i]->film != film)
+    {
+        i = (i + 1) & view->mask;
+    }
+
+    return i;
+}
+
+static void view_grow(View* view)
+{
+    ViewNode** old = view->slots;
+    size_t capacity = (view->mask + 1) * 2;
+
+    view->slots = (ViewNode**)mvdb_alloc(capacity * sizeof(ViewNode*));
+    view->mask = capacity - 1;
+
+    for (size_t i = 0; i < capacity / 2; i++)
+    {
+        if (old[i] != NULL)
+        {
+            view->slots[view_slot(view, old[i]->film)] = old[i];
+        }
+    }
+
+    free(old);
+}
+
+static void view_unmap(View* view, size_t hole)
+{
+    for (size_t i = (hole + 1) & view->mask; view->slots[i] != NULL;
+            i = (i + 1) & view->mask)
+    {
+        size_t home = view_hash(view, view->slots[i]->film);
+
+        if (((i - home) & view->mask) >= ((i - hole) & view->mask))
+        {
+            view->slots[hole] = view->slots[i];
+            hole = i;
+        }
+    }
+
+    view->slots[hole] = NULL;
+    view->count--;
+}
+
+/*
+ * Treap ordered by (key, seq), heap ordered by priority. Every node carries
+ * the size of its subtree for view_at.
+ */
+static int node_size(const ViewNode* node)
+{
+    return node == NULL ? 0 : node->size;
+}
+
+static void node_resize(ViewNode* node)
+{
+    node->size = 1 + node_size(node->left) + node_size(node->right);
+}
+
+static int node_before(const ViewNode* a, const ViewNode* b)
+{
+    return a->key < b->key || (a->key == b->key && a->seq < b->seq);
+}
+
+static ViewNode* node_rotateRight(ViewNode* node)
+{
+    ViewNode* left = node->left;
+
+    node->left = left->right;
+    left->right = node;
+    node_resize(node);
+    node_resize(left);
+
+    return left;
+}
+
+static ViewNode* node_rotateLeft(ViewNode* node)
+{
+    ViewNode* right = node->right;
+
+    node->right = right->left;
+    right->left = node;
+    node_resize(node);
+    node_resize(right);
+
+    return right;
+}
+
+static ViewNode* node_insert(ViewNode* root, ViewNode* node)
+{
+    if (root == NULL)
+    {
+        node->left = node->right = NULL;
+        node->size = 1;
+
+        return node;
+    }
+
+    if (node_before(node, root))
+    {
+        root->left = node_insert(root->left, node);
+        node_resize(root);
+
+        if (root->left->priority > root->priority)
+        {
+            root = node_rotateRight(root);
+        }
+    }
+    else
+    {
+        root->right = node_insert(root->right, node);
+        node_resize(root);
+
+        if (root->right->priority > root->priority)
+        {
+            root = node_rotateLeft(root);
+        }
+    }
+
+    return root;
+}
+
+static ViewNode* node_join(ViewNode* left, ViewNode* right)
+{
+    if (left == NULL)
+    {
+        return right;
+    }
+    if (right == NULL)
+    {
+        return left;
+    }
+
+    if (left->priority > right->priority)
+    {
+        left->right = node_join(left->right, right);
+        node_resize(left);
+
+        return left;
+    }
+
+    right->left = node_join(left, right->left);
+    node_resize(right);
+
+    return right;
+}
+
+/*
+ * Unlinks node, found by the key it was inserted with.
+ */
+static ViewNode* node_remove(ViewNode* root, ViewNode* node)
+{
+    if (root == node)
+    {
+        return node_join(node->left, node->right);
+    }
+
+    if (node_before(node, root))
+    {
+        root->left = node_remove(root->left, node);
+    }
+    else
+    {
+        root->right = node_remove(root->right, node);
+    }
+
+    node_resize(root);
+
+    return root;
+}
+
+static void node_free(ViewNode* node)
+{
+    if (node != NULL)
+    {
+        node_free(node->left);
+        node_free(node->right);
+        free(node);
+    }
+}
+
+static unsigned int view_priority(View* view)
+{
+    view->seed ^= view->seed << 13;
+    view->seed ^= view->seed >> 17;
+    view->seed ^= view->seed << 5;
+
+    return view->seed;
+}
+
+static void view_insert(View* view, Film* film)
+{
+    ViewNode* node = (ViewNode*)mvdb_alloc(sizeof(ViewNode));
+
+    node->film = film;
+    node->key = view_key(view, film);
+    node->seq = view->seq++;
+    node->priority = view_priority(view);
+
+    view->root = node_insert(view->root, node);
+    view->slots[view_slot(view, film)] = node;
+    view->count++;
+
+    if (view->count * 2 > view->mask + 1)
+    {
+        view_grow(view);
+    }
+}
+
+static void view_remove(View* view, size_t slot)
+{
+    ViewNode* node = view->slots[slot];
+
+    view->root = node_remove(view->root, node);
+    view_unmap(view, slot);
+    free(node);
+}
+
+static void view_clear(View* view)
+{
+    node_free(view->root);
+    view->root = NULL;
+    memset(view->slots, 0, (view->mask + 1) * sizeof(ViewNode*));
+    view->count = 0;
+}
+
+static void view_listener(void* context, const JournalEntry* entry)
+{
+    View* view = (View*)context;
+    size_t slot;
+
+    switch (entry->op)
+    {
+        case JOURNAL_INSERT:
+            if (view_holds(view, entry->film))
+            {
+                view_insert(view, entry->film);
+            }
+            break;
+
+        case JOURNAL_DELETE:
+            slot = view_slot(view, entry->film);
+
+            if (view->slots[slot] != NULL)
+            {
+                view_remove(view, slot);
+            }
+            break;
+
+        case JOURNAL_UPDATE:
+            if (!view_affects(view, entry->field))
+            {
+                break;
+            }
+
+            slot = view_slot(view, entry->film);
+
+            if (view->slots[slot] == NULL)
+            {
+                if (view_holds(view, entry->film))
+                {
+                    view_insert(view, entry->film);
+                }
+            }
+            else if (!view_holds(view, entry->film))
+            {
+                view_remove(view, slot);
+            }
+            else
+            {
+                /* Same place among equal keys, so the tie order is kept */
+                ViewNode* node = view->slots[slot];
+
+                view->root = node_remove(view->root, node);
+                node->key = view_key(view, entry->film);
+                view->root = node_insert(view->root, node);
+            }
+            break;
+
+        case JOURNAL_CLEAR:
+            view_clear(view);
+            break;
+    }
+}
+
+View* view_new(List* list, ViewOrder order, const char* genre)
+{
+    View* view = (View*)mvdb_alloc(sizeof(View));
+
+    view->order = order;
+    view->seed = 2463534242u;
+    view->mask = 15;
+    view->slots = (ViewNode**)mvdb_alloc(16 * sizeof(ViewNode*));
+
+    if (genre != NULL)
+    {
+        snprintf(view->genre, sizeof(view->genre), "%s", genre);
+    }
+
+    for (Iterator i = list_begin(list); i != list_end(list);
+            i = iterator_next(i))
+    {
+        if (view_holds(view, iterator_value(i)))
+        {
+            view_insert(view, iterator_value(i));
+        }
+    }
+
+    view->journal = list_journal(list);
+    journal_listen(view->journal, view_listener, view);
+
+    return view;
+}
+
+int view_size(const View* view)
+{
+    return node_size(view->root);
+}
+
+Film* view_at(const View* view, int rank)
+{
+    ViewNode* node = view->root;
+
+    while (node != NULL)
+    {
+        int left = node_size(node->left);
+
+        if (rank < left)
+        {
+            node = node->left;
+        }
+        else if (rank == left)
+        {
+            return node->film;
+        }
+        else
+        {
+            rank -= left + 1;
+            node = node->right;
+        }
+    }
+
+    return NULL;
+}
+
+static void view_collect(const ViewNode* node, Film** films, int k, int* got)
+{
+    if (node == NULL || *got == k)
+    {
+        return;
+    }
+
+    view_collect(node->left, films, k, got);
+
+    if (*got < k)
+    {
+        films[(*got)++] = node->film;
+        view_collect(node->right, films, k, got);
+    }
+}
+
+int view_top(const View* view, Film** films, int k)
+{
+    int got = 0;
+
+    view_collect(view->root, films, k, &got);
+
+    return got;
+}
+
+void view_free(View* view)
+{
+    journal_unlisten(view->journal, view_listener, view);
+    node_free(view->root);
+    free(view->slots);
+    free(view);
+}
+
+size_t view_bytes(const View* view)
+{
+    return sizeof(View) + view->count * sizeof(ViewNode)
+            + (view->mask + 1) * sizeof(ViewNode*);
+}
@@ -0,0 +1,158 @@
+/*
+ * File         : view.h
+ *
+ * Date         : Monday 19th October 2026
+ *
+ * Author       : Christopher Irvine, ruw12gbu, 100036248
+ *
+ * Description  : Header file that defines materialized views over a list.
+ *                A view holds the films of one genre (or every film) in a
+ *                fixed order, such as highest rated first, and answers "the
+ *                k-th film" or "the top k films" without sorting. It listens
+ *                to the list's change journal (see journal.h) and moves only
+ *                the film that changed, so each insert, delete or update
+ *                costs O(log n) rather than a full re-sort.
+ *
+ *                Films are kept in a treap ordered by key and then by the
+ *                order they joined the view, so ties come out in list order
+ *                as they would from the stable sorts in moviedatabase.c. A
+ *                hash table from Film to treap node finds the node to move
+ *                without reading the film's old values.
+ *
+ * History      : 19/10/2026 v1.00
+ *                19/10/2026 v1.10 - view_bytes.
+ */
+
+#ifndef VIEW_H
+#define VIEW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "film.h"
+#include "moviedatabase.h"
+
+typedef enum _ViewOrder
+{
+    VIEW_LONGEST,
+    VIEW_HIGHEST_RATED,
+    VIEW_SHORTEST_TITLE
+}ViewOrder;
+
+typedef struct _ViewNode
+{
+    double key;
+    long seq;
+    unsigned int priority;
+    int size;
+    Film* film;
+    struct _ViewNode* left;
+    struct _ViewNode* right;
+}ViewNode;
+
+typedef struct _View
+{
+    Journal* journal;
+    ViewOrder order;
+    char genre[100];
+    ViewNode* root;
+    ViewNode** slots;
+    size_t mask;
+    size_t count;
+    long seq;
+    unsigned int seed;
+}View;
+
+/*******************************************************************************
+
+Procedure   : view_new
+
+Parameters  : List* list - a filled linked list of Film structs
+              ViewOrder order - order the view keeps its films in
+              const char* genre - only hold films of this genre, or NULL for
+                                  every film
+
+Returns     : View* - a view of the films now in the list
+
+Description : Builds the view from the list in list order, then registers it
+              with list_journal(list) so it follows every later change.
+
+ ******************************************************************************/
+View* view_new(List* list, ViewOrder order, const char* genre);
+
+/*******************************************************************************
+
+Procedure   : view_size
+
+Parameters  : const View* view - view to read
+
+Returns     : int - number of films in the view
+
+Description : Number of films the view holds.
+
+ ******************************************************************************/
+int view_size(const View* view);
+
+/*******************************************************************************
+
+Procedure   : view_at
+
+Parameters  : const View* view - view to read
+              int rank - position wanted, 0 being the first
+
+Returns     : Film* - the film at that position, or NULL if there is none
+
+Description : Order statistic lookup in O(log n).
+
+ ******************************************************************************/
+Film* view_at(const View* view, int rank);
+
+/*******************************************************************************
+
+Procedure   : view_top
+
+Parameters  : const View* view - view to read
+              Film** films - filled with up to k films, first first
+              int k - number of films wanted
+
+Returns     : int - number of films written to films
+
+Description : Reads the first k films of the view in O(k + log n).
+
+ ******************************************************************************/
+int view_top(const View* view, Film** films, int k);
+
+/*******************************************************************************
+
+Procedure   : view_free
+
+Parameters  : View* view - view to free
+
+Returns     : void
+
+Description : Stops the view listening to its journal and frees it. The films
+              are not freed.
+
+ ******************************************************************************/
+void view_free(View* view);
+
+/*******************************************************************************
+
+Procedure   : view_bytes
+
+Parameters  : const View* view - view from view_new
+
+Returns     : size_t - bytes allocated for the view, its nodes and its table
+                       of films
+
+Description : For adding a view to ListMemory.indexes.
+
+ ******************************************************************************/
+size_t view_bytes(const View* view);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VIEW_H */